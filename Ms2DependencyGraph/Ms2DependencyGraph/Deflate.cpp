@@ -0,0 +1,934 @@
+#include "Deflate.h"
+
+#include <algorithm>
+#include <array>
+#include <queue>
+#include <vector>
+
+namespace
+{
+	const int lengthBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+	const int lengthExtra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+	const int distanceBase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+	const int distanceExtra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+	// the order code length code lengths are stored in a dynamic block header
+	const int codeLengthOrder[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+	const int literalCodeCount = 286;
+	const int distanceCodeCount = 30;
+	const int windowSize = 1 << 15;
+	const int minMatch = 3;
+	const int maxMatch = 258;
+	const int hashBits = 15;
+	const size_t blockSymbols = 1 << 16;
+	const size_t maxStoredBlock = 65535;
+
+	// chain length and the match length that ends the search early, by level
+	const int maxChain[10] = { 0, 4, 8, 16, 32, 64, 128, 256, 1024, 4096 };
+	const int niceLength[10] = { 0, 16, 32, 32, 64, 128, 128, 258, 258, 258 };
+
+	// a literal when Distance is 0, otherwise a match of Value bytes
+	struct DeflateSymbol
+	{
+		uint16_t Value = 0;
+		uint16_t Distance = 0;
+	};
+
+	struct HuffmanCodes
+	{
+		uint8_t LiteralLengths[288] = { 0 };
+		uint16_t LiteralCodes[288] = { 0 };
+		uint8_t DistanceLengths[32] = { 0 };
+		uint16_t DistanceCodes[32] = { 0 };
+	};
+
+	int lengthCode(int length)
+	{
+		return (int)(std::upper_bound(lengthBase, lengthBase + 29, length) - lengthBase) - 1;
+	}
+
+	int distanceCode(int distance)
+	{
+		return (int)(std::upper_bound(distanceBase, distanceBase + 30, distance) - distanceBase) - 1;
+	}
+
+	uint16_t reverseBits(uint32_t code, int length)
+	{
+		uint32_t reversed = 0;
+
+		for (int i = 0; i < length; ++i)
+		{
+			reversed = (reversed << 1) | (code & 1);
+			code >>= 1;
+		}
+
+		return (uint16_t)reversed;
+	}
+
+	// canonical codes, stored bit reversed since deflate packs bits from the least significant end
+	void assignCodes(const uint8_t* lengths, int count, uint16_t* codes)
+	{
+		int lengthCounts[16] = { 0 };
+
+		for (int i = 0; i < count; ++i)
+			++lengthCounts[lengths[i]];
+
+		lengthCounts[0] = 0;
+
+		int nextCode[16] = { 0 };
+		int code = 0;
+
+		for (int bits = 1; bits < 16; ++bits)
+		{
+			code = (code + lengthCounts[bits - 1]) << 1;
+			nextCode[bits] = code;
+		}
+
+		for (int i = 0; i < count; ++i)
+			if (lengths[i] != 0)
+				codes[i] = reverseBits(nextCode[lengths[i]]++, lengths[i]);
+	}
+
+	// Huffman code lengths for the frequencies. Codes deeper than maxLength are avoided by halving the frequencies and
+	// building again, which flattens the tree until it fits.
+	void buildLengths(const uint32_t* frequencies, int count, int maxLength, uint8_t* lengths)
+	{
+		struct Node
+		{
+			uint64_t Weight = 0;
+			int Left = -1;
+			int Right = -1;
+		};
+
+		std::vector<uint32_t> weights(frequencies, frequencies + count);
+		std::vector<Node> nodes;
+		std::vector<std::pair<int, int>> pending;
+
+		while (true)
+		{
+			std::fill(lengths, lengths + count, 0);
+
+			nodes.clear();
+
+			using Entry = std::pair<uint64_t, int>;
+
+			std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+
+			for (int i = 0; i < count; ++i)
+			{
+				if (weights[i] == 0)
+					continue;
+
+				queue.push(Entry(weights[i], (int)nodes.size()));
+				nodes.push_back(Node{ weights[i], -1, i });
+			}
+
+			if (nodes.size() == 0)
+				return;
+
+			if (nodes.size() == 1)
+			{
+				lengths[nodes[0].Right] = 1;
+
+				return;
+			}
+
+			while (queue.size() > 1)
+			{
+				Entry left = queue.top();
+				queue.pop();
+
+				Entry right = queue.top();
+				queue.pop();
+
+				queue.push(Entry(left.first + right.first, (int)nodes.size()));
+				nodes.push_back(Node{ left.first + right.first, left.second, right.second });
+			}
+
+			int deepest = 0;
+
+			pending.clear();
+			pending.push_back(std::make_pair(queue.top().second, 0));
+
+			while (pending.size() > 0)
+			{
+				std::pair<int, int> node = pending.back();
+				pending.pop_back();
+
+				const Node& current = nodes[node.first];
+
+				if (current.Left == -1)
+				{
+					lengths[current.Right] = (uint8_t)std::min(node.second, 255);
+					deepest = std::max(deepest, node.second);
+
+					continue;
+				}
+
+				pending.push_back(std::make_pair(current.Left, node.second + 1));
+				pending.push_back(std::make_pair(current.Right, node.second + 1));
+			}
+
+			if (deepest <= maxLength)
+				return;
+
+			for (uint32_t& weight : weights)
+				if (weight != 0)
+					weight = (weight + 1) / 2;
+		}
+	}
+
+	const HuffmanCodes& getFixedCodes()
+	{
+		static const HuffmanCodes codes = []()
+		{
+			HuffmanCodes fixed;
+
+			for (int i = 0; i < 288; ++i)
+				fixed.LiteralLengths[i] = i < 144 ? 8 : i < 256 ? 9 : i < 280 ? 7 : 8;
+
+			for (int i = 0; i < 32; ++i)
+				fixed.DistanceLengths[i] = 5;
+
+			assignCodes(fixed.LiteralLengths, 288, fixed.LiteralCodes);
+			assignCodes(fixed.DistanceLengths, 32, fixed.DistanceCodes);
+
+			return fixed;
+		}();
+
+		return codes;
+	}
+
+	struct BitWriter
+	{
+		std::string& Output;
+		uint64_t Bits = 0;
+		int Count = 0;
+
+		BitWriter(std::string& output) : Output(output) {}
+
+		void Write(uint32_t value, int length)
+		{
+			Bits |= (uint64_t)value << Count;
+			Count += length;
+
+			while (Count >= 8)
+			{
+				Output.push_back((char)(Bits & 0xFF));
+
+				Bits >>= 8;
+				Count -= 8;
+			}
+		}
+
+		void AlignToByte()
+		{
+			if (Count > 0)
+				Output.push_back((char)(Bits & 0xFF));
+
+			Bits = 0;
+			Count = 0;
+		}
+	};
+
+	// code length code symbols for the literal and distance lengths, with 16, 17 and 18 covering runs
+	void encodeLengths(const uint8_t* lengths, int count, std::vector<DeflateSymbol>& output)
+	{
+		for (int i = 0; i < count;)
+		{
+			int value = lengths[i];
+			int run = 1;
+
+			while (i + run < count && lengths[i + run] == value)
+				++run;
+
+			i += run;
+
+			if (value == 0)
+			{
+				for (; run >= 11; run -= std::min(run, 138))
+					output.push_back(DeflateSymbol{ 18, (uint16_t)(std::min(run, 138) - 11) });
+
+				if (run >= 3)
+				{
+					output.push_back(DeflateSymbol{ 17, (uint16_t)(run - 3) });
+
+					run = 0;
+				}
+			}
+			else
+			{
+				output.push_back(DeflateSymbol{ (uint16_t)value, 0 });
+
+				for (--run; run >= 3; run -= std::min(run, 6))
+					output.push_back(DeflateSymbol{ 16, (uint16_t)(std::min(run, 6) - 3) });
+			}
+
+			for (; run > 0; --run)
+				output.push_back(DeflateSymbol{ (uint16_t)value, 0 });
+		}
+	}
+
+	void writeSymbols(BitWriter& writer, const HuffmanCodes& codes, const std::vector<DeflateSymbol>& symbols)
+	{
+		for (const DeflateSymbol& symbol : symbols)
+		{
+			if (symbol.Distance == 0)
+			{
+				writer.Write(codes.LiteralCodes[symbol.Value], codes.LiteralLengths[symbol.Value]);
+
+				continue;
+			}
+
+			int length = lengthCode(symbol.Value);
+			int distance = distanceCode(symbol.Distance);
+
+			writer.Write(codes.LiteralCodes[257 + length], codes.LiteralLengths[257 + length]);
+			writer.Write(symbol.Value - lengthBase[length], lengthExtra[length]);
+			writer.Write(codes.DistanceCodes[distance], codes.DistanceLengths[distance]);
+			writer.Write(symbol.Distance - distanceBase[distance], distanceExtra[distance]);
+		}
+
+		writer.Write(codes.LiteralCodes[256], codes.LiteralLengths[256]);
+	}
+
+	uint64_t symbolBits(const HuffmanCodes& codes, const uint32_t* literalFrequencies, const uint32_t* distanceFrequencies)
+	{
+		uint64_t bits = 0;
+
+		for (int i = 0; i < literalCodeCount; ++i)
+			bits += (uint64_t)literalFrequencies[i] * (codes.LiteralLengths[i] + (i > 256 ? lengthExtra[i - 257] : 0));
+
+		for (int i = 0; i < distanceCodeCount; ++i)
+			bits += (uint64_t)distanceFrequencies[i] * (codes.DistanceLengths[i] + distanceExtra[i]);
+
+		return bits;
+	}
+
+	void writeBlock(BitWriter& writer, const std::vector<DeflateSymbol>& symbols, std::string_view raw, bool final)
+	{
+		uint32_t literalFrequencies[literalCodeCount] = { 0 };
+		uint32_t distanceFrequencies[distanceCodeCount] = { 0 };
+
+		for (const DeflateSymbol& symbol : symbols)
+		{
+			if (symbol.Distance == 0)
+				++literalFrequencies[symbol.Value];
+			else
+			{
+				++literalFrequencies[257 + lengthCode(symbol.Value)];
+				++distanceFrequencies[distanceCode(symbol.Distance)];
+			}
+		}
+
+		literalFrequencies[256] = 1;
+
+		// some decoders reject a code with a single symbol, so both alphabets get at least two
+		const auto useTwoCodes = [](uint32_t* frequencies, int count)
+		{
+			if (std::count_if(frequencies, frequencies + count, [](uint32_t frequency) { return frequency != 0; }) >= 2)
+				return;
+
+			frequencies[0] = std::max(frequencies[0], 1u);
+			frequencies[1] = std::max(frequencies[1], 1u);
+		};
+
+		useTwoCodes(literalFrequencies, literalCodeCount);
+		useTwoCodes(distanceFrequencies, distanceCodeCount);
+
+		HuffmanCodes dynamic;
+
+		buildLengths(literalFrequencies, literalCodeCount, 15, dynamic.LiteralLengths);
+		buildLengths(distanceFrequencies, distanceCodeCount, 15, dynamic.DistanceLengths);
+		assignCodes(dynamic.LiteralLengths, literalCodeCount, dynamic.LiteralCodes);
+		assignCodes(dynamic.DistanceLengths, distanceCodeCount, dynamic.DistanceCodes);
+
+		int literalCount = literalCodeCount;
+		int distanceCount = distanceCodeCount;
+
+		while (literalCount > 257 && dynamic.LiteralLengths[literalCount - 1] == 0)
+			--literalCount;
+
+		while (distanceCount > 1 && dynamic.DistanceLengths[distanceCount - 1] == 0)
+			--distanceCount;
+
+		uint8_t lengths[literalCodeCount + distanceCodeCount] = { 0 };
+
+		std::copy(dynamic.LiteralLengths, dynamic.LiteralLengths + literalCount, lengths);
+		std::copy(dynamic.DistanceLengths, dynamic.DistanceLengths + distanceCount, lengths + literalCount);
+
+		std::vector<DeflateSymbol> lengthSymbols;
+
+		encodeLengths(lengths, literalCount + distanceCount, lengthSymbols);
+
+		uint32_t lengthFrequencies[19] = { 0 };
+
+		for (const DeflateSymbol& symbol : lengthSymbols)
+			++lengthFrequencies[symbol.Value];
+
+		uint8_t lengthLengths[19] = { 0 };
+		uint16_t lengthCodes[19] = { 0 };
+
+		buildLengths(lengthFrequencies, 19, 7, lengthLengths);
+		assignCodes(lengthLengths, 19, lengthCodes);
+
+		int lengthCount = 19;
+
+		while (lengthCount > 4 && lengthLengths[codeLengthOrder[lengthCount - 1]] == 0)
+			--lengthCount;
+
+		const int repeatExtra[3] = { 2, 3, 7 };
+
+		uint64_t dynamicBits = 14 + 3 * (uint64_t)lengthCount + symbolBits(dynamic, literalFrequencies, distanceFrequencies);
+
+		for (const DeflateSymbol& symbol : lengthSymbols)
+			dynamicBits += lengthLengths[symbol.Value] + (symbol.Value >= 16 ? repeatExtra[symbol.Value - 16] : 0);
+
+		uint64_t fixedBits = symbolBits(getFixedCodes(), literalFrequencies, distanceFrequencies);
+		uint64_t storedBits = (raw.size() + 5 * (raw.size() / maxStoredBlock + 1)) * 8;
+
+		if (storedBits < fixedBits && storedBits < dynamicBits)
+		{
+			size_t offset = 0;
+
+			do
+			{
+				size_t length = std::min(raw.size() - offset, maxStoredBlock);
+
+				writer.Write(final && offset + length == raw.size() ? 1 : 0, 1);
+				writer.Write(0, 2);
+				writer.AlignToByte();
+				writer.Write((uint32_t)length, 16);
+				writer.Write((uint32_t)~length & 0xFFFF, 16);
+
+				writer.Output.append(raw.substr(offset, length));
+
+				offset += length;
+			}
+			while (offset < raw.size());
+
+			return;
+		}
+
+		writer.Write(final ? 1 : 0, 1);
+
+		if (fixedBits <= dynamicBits)
+		{
+			writer.Write(1, 2);
+
+			writeSymbols(writer, getFixedCodes(), symbols);
+
+			return;
+		}
+
+		writer.Write(2, 2);
+		writer.Write(literalCount - 257, 5);
+		writer.Write(distanceCount - 1, 5);
+		writer.Write(lengthCount - 4, 4);
+
+		for (int i = 0; i < lengthCount; ++i)
+			writer.Write(lengthLengths[codeLengthOrder[i]], 3);
+
+		for (const DeflateSymbol& symbol : lengthSymbols)
+		{
+			writer.Write(lengthCodes[symbol.Value], lengthLengths[symbol.Value]);
+
+			if (symbol.Value >= 16)
+				writer.Write(symbol.Distance, repeatExtra[symbol.Value - 16]);
+		}
+
+		writeSymbols(writer, dynamic, symbols);
+	}
+
+	struct BitReader
+	{
+		std::string_view Data;
+		size_t Position = 0;
+		uint64_t Bits = 0;
+		int Count = 0;
+		bool Failed = false;
+
+		uint32_t Read(int length)
+		{
+			while (Count < length)
+			{
+				if (Position == Data.size())
+				{
+					Failed = true;
+
+					return 0;
+				}
+
+				Bits |= (uint64_t)(unsigned char)Data[Position++] << Count;
+				Count += 8;
+			}
+
+			uint32_t value = (uint32_t)(Bits & ((1ull << length) - 1));
+
+			Bits >>= length;
+			Count -= length;
+
+			return value;
+		}
+	};
+
+	struct HuffmanTable
+	{
+		uint16_t Counts[16] = { 0 };
+		uint16_t Symbols[288] = { 0 };
+	};
+
+	// incomplete codes are accepted, over subscribed ones are not
+	bool buildTable(HuffmanTable& table, const uint8_t* lengths, int count)
+	{
+		std::fill(std::begin(table.Counts), std::end(table.Counts), 0);
+
+		for (int i = 0; i < count; ++i)
+			++table.Counts[lengths[i]];
+
+		int left = 1;
+
+		for (int bits = 1; bits < 16; ++bits)
+		{
+			left = (left << 1) - table.Counts[bits];
+
+			if (left < 0)
+				return false;
+		}
+
+		uint16_t offsets[16] = { 0 };
+
+		for (int bits = 1; bits < 15; ++bits)
+			offsets[bits + 1] = offsets[bits] + table.Counts[bits];
+
+		for (int i = 0; i < count; ++i)
+			if (lengths[i] != 0)
+				table.Symbols[offsets[lengths[i]]++] = (uint16_t)i;
+
+		return true;
+	}
+
+	int decodeSymbol(BitReader& reader, const HuffmanTable& table)
+	{
+		int code = 0;
+		int first = 0;
+		int index = 0;
+
+		for (int bits = 1; bits < 16; ++bits)
+		{
+			code |= (int)reader.Read(1);
+
+			int count = table.Counts[bits];
+
+			if (code - count < first)
+				return table.Symbols[index + (code - first)];
+
+			index += count;
+			first = (first + count) << 1;
+			code <<= 1;
+
+			if (reader.Failed)
+				return -1;
+		}
+
+		return -1;
+	}
+
+	bool inflateCodes(BitReader& reader, const HuffmanTable& literals, const HuffmanTable& distances, std::string& output, size_t memberStart)
+	{
+		while (true)
+		{
+			int symbol = decodeSymbol(reader, literals);
+
+			if (symbol < 0)
+				return false;
+
+			if (symbol < 256)
+			{
+				output.push_back((char)symbol);
+
+				continue;
+			}
+
+			if (symbol == 256)
+				return true;
+
+			symbol -= 257;
+
+			if (symbol >= 29)
+				return false;
+
+			size_t length = lengthBase[symbol] + reader.Read(lengthExtra[symbol]);
+
+			symbol = decodeSymbol(reader, distances);
+
+			if (symbol < 0 || symbol >= 30)
+				return false;
+
+			size_t distance = distanceBase[symbol] + reader.Read(distanceExtra[symbol]);
+
+			if (reader.Failed || distance > output.size() - memberStart)
+				return false;
+
+			size_t from = output.size() - distance;
+
+			for (size_t i = 0; i < length; ++i)
+				output.push_back(output[from + i]);
+		}
+	}
+
+	// appends the inflated stream to output; reader is left just past the final block
+	bool inflateStream(BitReader& reader, std::string& output)
+	{
+		size_t memberStart = output.size();
+
+		static const std::pair<HuffmanTable, HuffmanTable> fixedTables = []()
+		{
+			const HuffmanCodes& codes = getFixedCodes();
+
+			std::pair<HuffmanTable, HuffmanTable> tables;
+
+			buildTable(tables.first, codes.LiteralLengths, 288);
+			buildTable(tables.second, codes.DistanceLengths, 30);
+
+			return tables;
+		}();
+
+		bool final = false;
+
+		while (!final)
+		{
+			final = reader.Read(1) == 1;
+
+			uint32_t type = reader.Read(2);
+
+			if (type == 0)
+			{
+				reader.Bits = 0;
+				reader.Count = 0;
+
+				uint32_t length = reader.Read(16);
+				uint32_t complement = reader.Read(16);
+
+				if (reader.Failed || length != (~complement & 0xFFFF) || reader.Data.size() - reader.Position < length)
+					return false;
+
+				output.append(reader.Data.substr(reader.Position, length));
+
+				reader.Position += length;
+			}
+			else if (type == 1)
+			{
+				if (!inflateCodes(reader, fixedTables.first, fixedTables.second, output, memberStart))
+					return false;
+			}
+			else if (type == 2)
+			{
+				int literalCount = (int)reader.Read(5) + 257;
+				int distanceCount = (int)reader.Read(5) + 1;
+				int lengthCount = (int)reader.Read(4) + 4;
+
+				if (literalCount > literalCodeCount || distanceCount > distanceCodeCount)
+					return false;
+
+				uint8_t lengthLengths[19] = { 0 };
+
+				for (int i = 0; i < lengthCount; ++i)
+					lengthLengths[codeLengthOrder[i]] = (uint8_t)reader.Read(3);
+
+				HuffmanTable lengthTable;
+
+				if (!buildTable(lengthTable, lengthLengths, 19))
+					return false;
+
+				uint8_t lengths[literalCodeCount + distanceCodeCount] = { 0 };
+
+				for (int i = 0; i < literalCount + distanceCount;)
+				{
+					int symbol = decodeSymbol(reader, lengthTable);
+
+					if (symbol < 0)
+						return false;
+
+					if (symbol < 16)
+					{
+						lengths[i++] = (uint8_t)symbol;
+
+						continue;
+					}
+
+					uint8_t value = 0;
+					int repeat = 0;
+
+					if (symbol == 16)
+					{
+						if (i == 0)
+							return false;
+
+						value = lengths[i - 1];
+						repeat = 3 + (int)reader.Read(2);
+					}
+					else if (symbol == 17)
+						repeat = 3 + (int)reader.Read(3);
+					else
+						repeat = 11 + (int)reader.Read(7);
+
+					if (i + repeat > literalCount + distanceCount)
+						return false;
+
+					for (; repeat > 0; --repeat)
+						lengths[i++] = value;
+				}
+
+				HuffmanTable literals;
+				HuffmanTable distances;
+
+				if (lengths[256] == 0 || !buildTable(literals, lengths, literalCount) || !buildTable(distances, lengths + literalCount, distanceCount))
+					return false;
+
+				if (!inflateCodes(reader, literals, distances, output, memberStart))
+					return false;
+			}
+			else
+				return false;
+
+			if (reader.Failed)
+				return false;
+		}
+
+		return true;
+	}
+
+	void writeLittleEndian(std::string& output, uint32_t value)
+	{
+		for (int i = 0; i < 4; ++i)
+			output.push_back((char)((value >> (8 * i)) & 0xFF));
+	}
+
+	uint32_t readLittleEndian(std::string_view data, size_t position)
+	{
+		uint32_t value = 0;
+
+		for (int i = 0; i < 4; ++i)
+			value |= (uint32_t)(unsigned char)data[position + i] << (8 * i);
+
+		return value;
+	}
+}
+
+void deflateText(std::string_view text, int level, std::string& output)
+{
+	level = std::clamp(level, 1, 9);
+
+	const unsigned char* data = (const unsigned char*)text.data();
+	const int size = (int)text.size();
+	const int hashMask = (1 << hashBits) - 1;
+
+	std::vector<int> head(1 << hashBits, -1);
+	std::vector<int> previous(windowSize, -1);
+	std::vector<DeflateSymbol> symbols;
+
+	symbols.reserve(blockSymbols);
+
+	BitWriter writer(output);
+
+	const auto hashAt = [data, hashMask](int position)
+	{
+		return ((data[position] << 10) ^ (data[position + 1] << 5) ^ data[position + 2]) & hashMask;
+	};
+
+	const auto insert = [&head, &previous, &hashAt](int position)
+	{
+		int hash = hashAt(position);
+
+		previous[position & (windowSize - 1)] = head[hash];
+		head[hash] = position;
+	};
+
+	int blockStart = 0;
+	int position = 0;
+
+	while (position < size)
+	{
+		int bestLength = 0;
+		int bestDistance = 0;
+
+		if (position + minMatch <= size)
+		{
+			int limit = std::min(maxMatch, size - position);
+			int candidate = head[hashAt(position)];
+
+			for (int chain = maxChain[level]; candidate >= 0 && position - candidate <= windowSize && chain > 0; --chain)
+			{
+				if (data[candidate + bestLength] == data[position + bestLength])
+				{
+					int length = 0;
+
+					while (length < limit && data[candidate + length] == data[position + length])
+						++length;
+
+					if (length > bestLength)
+					{
+						bestLength = length;
+						bestDistance = position - candidate;
+
+						if (length >= niceLength[level] || length == limit)
+							break;
+					}
+				}
+
+				int next = previous[candidate & (windowSize - 1)];
+
+				// the slot was reused by a newer position, the rest of the chain is gone
+				if (next >= candidate)
+					break;
+
+				candidate = next;
+			}
+
+			insert(position);
+		}
+
+		if (bestLength >= minMatch)
+		{
+			symbols.push_back(DeflateSymbol{ (uint16_t)bestLength, (uint16_t)bestDistance });
+
+			for (int i = position + 1; i < position + bestLength && i + minMatch <= size; ++i)
+				insert(i);
+
+			position += bestLength;
+		}
+		else
+		{
+			symbols.push_back(DeflateSymbol{ data[position], 0 });
+
+			++position;
+		}
+
+		if (symbols.size() >= blockSymbols)
+		{
+			writeBlock(writer, symbols, text.substr(blockStart, position - blockStart), false);
+
+			symbols.clear();
+			blockStart = position;
+		}
+	}
+
+	writeBlock(writer, symbols, text.substr(blockStart), true);
+	writer.AlignToByte();
+}
+
+bool inflateData(std::string_view data, std::string& output)
+{
+	output.clear();
+
+	BitReader reader{ data };
+
+	return inflateStream(reader, output);
+}
+
+uint32_t crc32(std::string_view data, uint32_t crc)
+{
+	static const std::array<uint32_t, 256> table = []()
+	{
+		std::array<uint32_t, 256> values;
+
+		for (uint32_t i = 0; i < 256; ++i)
+		{
+			uint32_t value = i;
+
+			for (int bit = 0; bit < 8; ++bit)
+				value = (value & 1) != 0 ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+
+			values[i] = value;
+		}
+
+		return values;
+	}();
+
+	crc = ~crc;
+
+	for (char character : data)
+		crc = table[(crc ^ (unsigned char)character) & 0xFF] ^ (crc >> 8);
+
+	return ~crc;
+}
+
+void gzipText(std::string_view text, int level, std::string& output)
+{
+	// no name or timestamp, so the same text always compresses to the same bytes
+	const char header[10] = { '\x1f', '\x8b', 8, 0, 0, 0, 0, 0, 0, '\xff' };
+
+	output.append(header, sizeof(header));
+
+	deflateText(text, level, output);
+
+	writeLittleEndian(output, crc32(text));
+	writeLittleEndian(output, (uint32_t)text.size());
+}
+
+bool gunzipData(std::string_view data, std::string& output)
+{
+	output.clear();
+
+	size_t position = 0;
+
+	while (position < data.size())
+	{
+		if (data.size() - position < 18 || data[position] != '\x1f' || data[position + 1] != '\x8b' || data[position + 2] != 8)
+			return false;
+
+		int flags = (unsigned char)data[position + 3];
+
+		position += 10;
+
+		if ((flags & 4) != 0)
+		{
+			if (data.size() - position < 2)
+				return false;
+
+			position += 2 + ((unsigned char)data[position] | ((unsigned char)data[position + 1] << 8));
+		}
+
+		for (int text : { 8, 16 })
+		{
+			if ((flags & text) == 0)
+				continue;
+
+			size_t end = data.find('\0', position);
+
+			if (end == std::string_view::npos)
+				return false;
+
+			position = end + 1;
+		}
+
+		if ((flags & 2) != 0)
+			position += 2;
+
+		if (position > data.size())
+			return false;
+
+		size_t memberStart = output.size();
+
+		BitReader reader{ data.substr(position) };
+
+		if (!inflateStream(reader, output))
+			return false;
+
+		position += reader.Position;
+
+		if (data.size() - position < 8)
+			return false;
+
+		std::string_view member = std::string_view(output).substr(memberStart);
+
+		if (readLittleEndian(data, position) != crc32(member) || readLittleEndian(data, position + 4) != (uint32_t)member.size())
+			return false;
+
+		position += 8;
+	}
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Self contained deflate (RFC 1951) and gzip (RFC 1952), so compressed output doesn't need zlib. Level 1 to 9 sets how
+// far back each position searches for a match. Blocks use whichever of fixed or per block Huffman codes is smaller.
+void deflateText(std::string_view text, int level, std::string& output);
+bool inflateData(std::string_view data, std::string& output);
+
+uint32_t crc32(std::string_view data, uint32_t crc = 0);
+
+// One gzip member; members can be concatenated and gzip readers decompress them as one stream.
+void gzipText(std::string_view text, int level, std::string& output);
+bool gunzipData(std::string_view data, std::string& output);
\ No newline at end of file
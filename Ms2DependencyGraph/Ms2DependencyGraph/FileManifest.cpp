@@ -0,0 +1,315 @@
+#include "FileManifest.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#endif
+
+namespace
+{
+	std::string rootKey(const fs::path& root)
+	{
+		std::string key = root.generic_string();
+
+		if (key.size() > 0 && key.back() != '/')
+			key.push_back('/');
+
+		return key;
+	}
+
+#ifdef _WIN32
+	int64_t readFileTime(const FILETIME& time)
+	{
+		return ((int64_t)time.dwHighDateTime << 32) | time.dwLowDateTime;
+	}
+
+	bool readDirectoryTime(const std::string& directory, int64_t& modifiedTime)
+	{
+		WIN32_FILE_ATTRIBUTE_DATA data;
+
+		if (!GetFileAttributesExW(fs::path(directory).c_str(), GetFileExInfoStandard, &data))
+			return false;
+
+		modifiedTime = readFileTime(data.ftLastWriteTime);
+
+		return true;
+	}
+#else
+	int64_t readFileTime(const struct stat& status)
+	{
+		return (int64_t)status.st_mtim.tv_sec * 1000000000 + status.st_mtim.tv_nsec;
+	}
+
+	bool readDirectoryTime(const std::string& directory, int64_t& modifiedTime)
+	{
+		struct stat status;
+
+		if (stat(directory.c_str(), &status) != 0)
+			return false;
+
+		modifiedTime = readFileTime(status);
+
+		return true;
+	}
+#endif
+}
+
+int readFileId(std::string_view fileName)
+{
+	int id = 0;
+
+	std::from_chars(fileName.data(), fileName.data() + fileName.size(), id);
+
+	return id;
+}
+
+uint32_t FileManifest::AddPath(std::string_view path)
+{
+	uint32_t offset = (uint32_t)Paths.size();
+
+	Paths += path;
+
+	return offset;
+}
+
+#ifdef _WIN32
+
+void FileManifest::Walk(const std::string& directory, size_t rootLength)
+{
+	WIN32_FIND_DATAW data;
+	HANDLE find = FindFirstFileExW(fs::path(directory + "*").c_str(), FindExInfoBasic, &data, FindExSearchNameMatch, nullptr, FIND_FIRST_EX_LARGE_FETCH);
+
+	if (find == INVALID_HANDLE_VALUE)
+		return;
+
+	int64_t directoryTime = 0;
+
+	readDirectoryTime(directory, directoryTime);
+
+	Directories.push_back(FileManifestDirectory{ AddPath(directory), (uint32_t)directory.size(), directoryTime });
+
+	std::vector<std::string> subdirectories;
+
+	do
+	{
+		if (wcscmp(data.cFileName, L".") == 0 || wcscmp(data.cFileName, L"..") == 0)
+			continue;
+
+		std::string name = fs::path(data.cFileName).string();
+
+		if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+		{
+			if (!(data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT))
+				subdirectories.push_back(directory + name + "/");
+
+			continue;
+		}
+
+		std::string path = directory.substr(rootLength) + name;
+
+		Entries.push_back(FileManifestEntry{ readFileId(name), AddPath(path), (uint32_t)path.size(), 0, ((uint64_t)data.nFileSizeHigh << 32) | data.nFileSizeLow, readFileTime(data.ftLastWriteTime) });
+	}
+	while (FindNextFileW(find, &data));
+
+	FindClose(find);
+
+	for (const std::string& subdirectory : subdirectories)
+		Walk(subdirectory, rootLength);
+}
+
+#else
+
+void FileManifest::Walk(const std::string& directory, size_t rootLength)
+{
+	DIR* handle = opendir(directory.c_str());
+
+	if (handle == nullptr)
+		return;
+
+	int directoryFile = dirfd(handle);
+	struct stat status;
+
+	fstat(directoryFile, &status);
+
+	Directories.push_back(FileManifestDirectory{ AddPath(directory), (uint32_t)directory.size(), readFileTime(status) });
+
+	std::vector<std::string> subdirectories;
+
+	while (dirent* entry = readdir(handle))
+	{
+		if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+			continue;
+
+		if (entry->d_type == DT_DIR)
+		{
+			subdirectories.push_back(directory + entry->d_name + "/");
+
+			continue;
+		}
+
+		if (fstatat(directoryFile, entry->d_name, &status, AT_SYMLINK_NOFOLLOW) != 0)
+			continue;
+
+		if (S_ISDIR(status.st_mode))
+		{
+			subdirectories.push_back(directory + entry->d_name + "/");
+
+			continue;
+		}
+
+		std::string path = directory.substr(rootLength) + entry->d_name;
+
+		Entries.push_back(FileManifestEntry{ readFileId(entry->d_name), AddPath(path), (uint32_t)path.size(), 0, (uint64_t)status.st_size, readFileTime(status) });
+	}
+
+	closedir(handle);
+
+	for (const std::string& subdirectory : subdirectories)
+		Walk(subdirectory, rootLength);
+}
+
+#endif
+
+void FileManifest::Build(const std::vector<fs::path>& roots)
+{
+	Roots.clear();
+	Directories.clear();
+	Entries.clear();
+	Paths.clear();
+
+	for (const fs::path& root : roots)
+	{
+		std::string key = rootKey(root);
+
+		FileManifestRoot manifestRoot{ AddPath(key), (uint32_t)key.size(), (uint32_t)Entries.size() };
+
+		Walk(key, key.size());
+
+		std::sort(Entries.begin() + manifestRoot.FirstEntry, Entries.end(), [this](const FileManifestEntry& left, const FileManifestEntry& right)
+		{
+			return GetPath(left.PathOffset, left.PathLength) < GetPath(right.PathOffset, right.PathLength);
+		});
+
+		manifestRoot.EntryCount = (uint32_t)Entries.size() - manifestRoot.FirstEntry;
+
+		Roots.push_back(manifestRoot);
+	}
+}
+
+bool FileManifest::Save(const fs::path& manifestPath) const
+{
+	if (manifestPath.has_parent_path())
+		fs::create_directories(manifestPath.parent_path());
+
+	std::ofstream outFile(manifestPath, std::ofstream::out | std::ofstream::binary);
+
+	if (!outFile.is_open())
+		return false;
+
+	FileManifestHeader header;
+
+	header.RootCount = (uint32_t)Roots.size();
+	header.DirectoryCount = (uint32_t)Directories.size();
+	header.EntryCount = (uint32_t)Entries.size();
+	header.PathsSize = (uint32_t)Paths.size();
+
+	outFile.write((const char*)&header, sizeof(header));
+	outFile.write((const char*)Roots.data(), Roots.size() * sizeof(FileManifestRoot));
+	outFile.write((const char*)Directories.data(), Directories.size() * sizeof(FileManifestDirectory));
+	outFile.write((const char*)Entries.data(), Entries.size() * sizeof(FileManifestEntry));
+	outFile.write(Paths.data(), Paths.size());
+
+	return outFile.good();
+}
+
+bool FileManifest::Load(const fs::path& manifestPath, const std::vector<fs::path>& roots)
+{
+	std::ifstream inFile(manifestPath, std::ifstream::in | std::ifstream::binary);
+
+	if (!inFile.is_open())
+		return false;
+
+	FileManifestHeader header;
+
+	if (!inFile.read((char*)&header, sizeof(header)) || memcmp(header.Magic, FileManifestHeader().Magic, 4) != 0 || header.Version != 1)
+		return false;
+
+	Roots.resize(header.RootCount);
+	Directories.resize(header.DirectoryCount);
+	Entries.resize(header.EntryCount);
+	Paths.resize(header.PathsSize);
+
+	inFile.read((char*)Roots.data(), Roots.size() * sizeof(FileManifestRoot));
+	inFile.read((char*)Directories.data(), Directories.size() * sizeof(FileManifestDirectory));
+	inFile.read((char*)Entries.data(), Entries.size() * sizeof(FileManifestEntry));
+	inFile.read(Paths.data(), Paths.size());
+
+	bool valid = inFile.good() && Roots.size() == roots.size();
+
+	for (size_t i = 0; valid && i < roots.size(); ++i)
+		valid = GetPath(Roots[i].PathOffset, Roots[i].PathLength) == rootKey(roots[i]);
+
+	for (size_t i = 0; valid && i < Directories.size(); ++i)
+	{
+		int64_t modifiedTime = 0;
+
+		valid = readDirectoryTime(std::string(GetPath(Directories[i].PathOffset, Directories[i].PathLength)), modifiedTime) && modifiedTime == Directories[i].ModifiedTime;
+	}
+
+	if (valid)
+		return true;
+
+	Roots.clear();
+	Directories.clear();
+	Entries.clear();
+	Paths.clear();
+
+	return false;
+}
+
+const FileManifestRoot* FileManifest::FindRoot(const fs::path& root) const
+{
+	std::string key = rootKey(root);
+
+	for (const FileManifestRoot& manifestRoot : Roots)
+		if (GetPath(manifestRoot.PathOffset, manifestRoot.PathLength) == key)
+			return &manifestRoot;
+
+	return nullptr;
+}
+
+bool FileManifest::HasRoot(const fs::path& root) const
+{
+	return FindRoot(root) != nullptr;
+}
+
+void FileManifest::ForEach(const fs::path& root, const std::function<void(const FileManifestEntry&, const fs::path&)>& callback) const
+{
+	const FileManifestRoot* manifestRoot = FindRoot(root);
+
+	if (manifestRoot == nullptr)
+		return;
+
+	std::string filePath(GetPath(manifestRoot->PathOffset, manifestRoot->PathLength));
+	size_t rootLength = filePath.size();
+
+	for (uint32_t i = 0; i < manifestRoot->EntryCount; ++i)
+	{
+		const FileManifestEntry& entry = Entries[manifestRoot->FirstEntry + i];
+
+		filePath.resize(rootLength);
+		filePath += GetPath(entry.PathOffset, entry.PathLength);
+
+		callback(entry, fs::path(filePath));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// Table files are named after their id, e.g. 10000001.xml.
+int readFileId(std::string_view fileName);
+
+// Persisted layout: FileManifestHeader, the roots, the directories, the entries, then every path in one block.
+struct FileManifestHeader
+{
+	char Magic[4] = { 'M', 'F', 'S', 'T' };
+	uint32_t Version = 1;
+	uint32_t RootCount = 0;
+	uint32_t DirectoryCount = 0;
+	uint32_t EntryCount = 0;
+	uint32_t PathsSize = 0;
+};
+
+// Path offsets index the manifest's path block. File paths are relative to their root.
+struct FileManifestEntry
+{
+	int32_t Id = 0;
+	uint32_t PathOffset = 0;
+	uint32_t PathLength = 0;
+	uint32_t Reserved = 0;
+	uint64_t Size = 0;
+	int64_t ModifiedTime = 0;
+};
+
+struct FileManifestRoot
+{
+	uint32_t PathOffset = 0;
+	uint32_t PathLength = 0;
+	uint32_t FirstEntry = 0;
+	uint32_t EntryCount = 0;
+};
+
+struct FileManifestDirectory
+{
+	uint32_t PathOffset = 0;
+	uint32_t PathLength = 0;
+	int64_t ModifiedTime = 0;
+};
+
+// Every file under the table roots, listed once with its id, size and modification time so later passes and later runs
+// don't have to walk the tree again. Directories are walked with bulk reads (readdir over getdents, or
+// FindFirstFileEx with large fetch) and file entries are kept sorted by path within each root.
+class FileManifest
+{
+public:
+	void Build(const std::vector<fs::path>& roots);
+
+	// Fails when the file is missing, was built for other roots, or any directory it lists has changed since.
+	bool Load(const fs::path& manifestPath, const std::vector<fs::path>& roots);
+	bool Save(const fs::path& manifestPath) const;
+
+	bool HasRoot(const fs::path& root) const;
+	void ForEach(const fs::path& root, const std::function<void(const FileManifestEntry&, const fs::path&)>& callback) const;
+
+	std::string_view GetPath(uint32_t offset, uint32_t length) const { return std::string_view(Paths).substr(offset, length); }
+
+private:
+	std::vector<FileManifestRoot> Roots;
+	std::vector<FileManifestDirectory> Directories;
+	std::vector<FileManifestEntry> Entries;
+	std::string Paths;
+
+	const FileManifestRoot* FindRoot(const fs::path& root) const;
+	uint32_t AddPath(std::string_view path);
+	void Walk(const std::string& directory, size_t rootLength);
+};
\ No newline at end of file
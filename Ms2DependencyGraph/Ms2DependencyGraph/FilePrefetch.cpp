@@ -0,0 +1,183 @@
+#include "FilePrefetch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+#include "IngestStats.h"
+
+PrefetchSettings prefetchSettings;
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	long long nanosecondsSince(Clock::time_point start)
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+	}
+
+	struct PrefetchBuffer
+	{
+		std::vector<char> Data;
+		size_t Length = 0;
+		bool Ready = false;
+		bool Failed = false;
+	};
+
+	// read n lives in buffer n % BufferCount, so it may start once read n - BufferCount has been parsed
+	struct PrefetchRing
+	{
+		std::mutex Lock;
+		std::condition_variable BufferReady;
+		std::condition_variable BufferFree;
+		std::vector<PrefetchBuffer> Buffers;
+		std::vector<int> Reads;
+		int NextRead = 0;
+		int ParsedReads = 0;
+
+		PrefetchStageStats Stats;
+	};
+
+	// the buffer only grows, so once it has seen the largest file in a stage it is never reallocated
+	bool readFile(const fs::path& filePath, PrefetchBuffer& buffer)
+	{
+		std::ifstream file(filePath, std::ifstream::in | std::ifstream::binary | std::ifstream::ate);
+
+		if (!file.is_open())
+			return false;
+
+		buffer.Length = (size_t)file.tellg();
+
+		if (buffer.Data.size() < buffer.Length)
+			buffer.Data.resize(buffer.Length);
+
+		file.seekg(0);
+		file.read(buffer.Data.data(), buffer.Length);
+
+		return (size_t)file.gcount() == buffer.Length;
+	}
+
+	void runReader(PrefetchRing& ring, const std::vector<XmlTableFile>& files)
+	{
+		long long readNanoseconds = 0;
+		long long ringFullNanoseconds = 0;
+		long long bytes = 0;
+
+		std::unique_lock<std::mutex> lock(ring.Lock);
+
+		while (ring.NextRead < (int)ring.Reads.size())
+		{
+			int read = ring.NextRead++;
+			int bufferCount = (int)ring.Buffers.size();
+
+			Clock::time_point waitStart = Clock::now();
+
+			ring.BufferFree.wait(lock, [&ring, read, bufferCount]() { return read < ring.ParsedReads + bufferCount; });
+
+			ringFullNanoseconds += nanosecondsSince(waitStart);
+
+			PrefetchBuffer& buffer = ring.Buffers[read % bufferCount];
+
+			lock.unlock();
+
+			Clock::time_point readStart = Clock::now();
+
+			buffer.Failed = !readFile(files[ring.Reads[read]].Path, buffer);
+
+			readNanoseconds += nanosecondsSince(readStart);
+			bytes += buffer.Failed ? 0 : (long long)buffer.Length;
+
+			lock.lock();
+
+			buffer.Ready = true;
+
+			ring.BufferReady.notify_all();
+		}
+
+		ring.Stats.ReadNanoseconds += readNanoseconds;
+		ring.Stats.RingFullNanoseconds += ringFullNanoseconds;
+		ring.Stats.Bytes += bytes;
+	}
+}
+
+void prefetchFiles(const std::string& stageName, const std::vector<XmlTableFile>& files, const std::function<bool(const XmlTableFile&)>& wanted, const std::function<void(const XmlTableFile&)>& callback)
+{
+	if (prefetchSettings.IoThreads <= 0)
+	{
+		for (const XmlTableFile& file : files)
+			callback(file);
+
+		return;
+	}
+
+	PrefetchRing ring;
+
+	ring.Stats.Name = stageName;
+	ring.Buffers.resize(std::max(1, prefetchSettings.BufferCount));
+
+	for (int i = 0; i < (int)files.size(); ++i)
+		if (wanted == nullptr || wanted(files[i]))
+			ring.Reads.push_back(i);
+
+	std::vector<std::thread> readers;
+
+	for (int i = 0; i < prefetchSettings.IoThreads && i < (int)ring.Reads.size(); ++i)
+		readers.push_back(std::thread([&ring, &files]() { runReader(ring, files); }));
+
+	XmlTableFile file;
+	int read = 0;
+
+	for (int i = 0; i < (int)files.size(); ++i)
+	{
+		if (read == (int)ring.Reads.size() || ring.Reads[read] != i)
+		{
+			callback(files[i]);
+
+			continue;
+		}
+
+		PrefetchBuffer& buffer = ring.Buffers[read % ring.Buffers.size()];
+
+		{
+			std::unique_lock<std::mutex> lock(ring.Lock);
+
+			Clock::time_point waitStart = Clock::now();
+
+			ring.BufferReady.wait(lock, [&buffer]() { return buffer.Ready; });
+
+			ring.Stats.ReadWaitNanoseconds += nanosecondsSince(waitStart);
+		}
+
+		file = files[i];
+
+		// a file that couldn't be read is left for the parser to open, so it fails the same way it did before
+		if (!buffer.Failed)
+			file.Text = std::string_view(buffer.Data.data(), buffer.Length);
+
+		Clock::time_point parseStart = Clock::now();
+
+		callback(file);
+
+		ring.Stats.ParseNanoseconds += nanosecondsSince(parseStart);
+		++ring.Stats.Files;
+		++read;
+
+		{
+			std::lock_guard<std::mutex> lock(ring.Lock);
+
+			buffer.Ready = false;
+			++ring.ParsedReads;
+		}
+
+		ring.BufferFree.notify_all();
+	}
+
+	for (std::thread& reader : readers)
+		reader.join();
+
+	ingestStats.PrefetchStages.push_back(ring.Stats);
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "XmlSource.h"
+
+struct PrefetchSettings
+{
+	// 0 leaves each file to be mapped by its parser when it is reached
+	int IoThreads = 2;
+	int BufferCount = 16;
+};
+
+extern PrefetchSettings prefetchSettings;
+
+// Reads the files ahead of the caller on IoThreads threads into a fixed ring of BufferCount buffers and hands them to
+// callback in list order with Text filled in. Readers stall while every buffer is still waiting to be parsed, and the
+// buffers keep their storage from file to file. Files wanted turns down are passed to callback unread.
+void prefetchFiles(const std::string& stageName, const std::vector<XmlTableFile>& files, const std::function<bool(const XmlTableFile&)>& wanted, const std::function<void(const XmlTableFile&)>& callback);
\ No newline at end of file
@@ -0,0 +1,272 @@
+#include "FileWatcher.h"
+
+#include <algorithm>
+#include <chrono>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	// the longest a batch is held back while changes keep coming
+	const std::chrono::milliseconds batchLimit(1000);
+
+	// a directory that shows up already has files in it, and no events will come for those
+	void addFiles(const fs::path& directory, std::vector<fs::path>& changed)
+	{
+		std::error_code error;
+
+		for (const fs::directory_entry& entry : fs::recursive_directory_iterator(directory, error))
+			if (entry.is_regular_file(error))
+				changed.push_back(entry.path());
+	}
+}
+
+bool FileWatcher::WaitForChanges(int quietMilliseconds, std::vector<fs::path>& changed)
+{
+	changed.clear();
+
+	while (changed.size() == 0)
+		if (!ReadEvents(-1, changed))
+			return false;
+
+	Clock::time_point batchStart = Clock::now();
+
+	for (size_t previousSize = 0; previousSize != changed.size() && Clock::now() - batchStart < batchLimit;)
+	{
+		previousSize = changed.size();
+
+		if (!ReadEvents(quietMilliseconds, changed))
+			return false;
+	}
+
+	std::sort(changed.begin(), changed.end());
+
+	changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+
+	return true;
+}
+
+#ifdef _WIN32
+
+struct FileWatcher::WatchedDirectory
+{
+	fs::path Path;
+	HANDLE Handle = INVALID_HANDLE_VALUE;
+	OVERLAPPED Overlapped = {};
+	alignas(DWORD) char Buffer[1 << 16];
+
+	~WatchedDirectory()
+	{
+		if (Handle != INVALID_HANDLE_VALUE)
+		{
+			CancelIo(Handle);
+			CloseHandle(Handle);
+		}
+
+		if (Overlapped.hEvent != nullptr)
+			CloseHandle(Overlapped.hEvent);
+	}
+
+	bool Read()
+	{
+		const DWORD filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE;
+
+		return ReadDirectoryChangesW(Handle, Buffer, sizeof(Buffer), TRUE, filter, nullptr, &Overlapped, nullptr) != 0;
+	}
+};
+
+FileWatcher::~FileWatcher()
+{
+}
+
+bool FileWatcher::Watch(const std::vector<fs::path>& directories)
+{
+	for (const fs::path& directory : directories)
+	{
+		std::unique_ptr<WatchedDirectory> watched = std::make_unique<WatchedDirectory>();
+
+		watched->Path = directory;
+		watched->Handle = CreateFileW(directory.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+
+		if (watched->Handle == INVALID_HANDLE_VALUE)
+			return false;
+
+		watched->Overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+
+		if (watched->Overlapped.hEvent == nullptr || !watched->Read())
+			return false;
+
+		Directories.push_back(std::move(watched));
+	}
+
+	return true;
+}
+
+bool FileWatcher::ReadEvents(int timeoutMilliseconds, std::vector<fs::path>& changed)
+{
+	std::vector<HANDLE> events;
+
+	for (const std::unique_ptr<WatchedDirectory>& directory : Directories)
+		events.push_back(directory->Overlapped.hEvent);
+
+	DWORD result = WaitForMultipleObjects((DWORD)events.size(), events.data(), FALSE, timeoutMilliseconds < 0 ? INFINITE : (DWORD)timeoutMilliseconds);
+
+	if (result == WAIT_TIMEOUT)
+		return true;
+
+	if (result < WAIT_OBJECT_0 || result >= WAIT_OBJECT_0 + events.size())
+		return false;
+
+	WatchedDirectory& directory = *Directories[result - WAIT_OBJECT_0];
+	DWORD length = 0;
+
+	if (!GetOverlappedResult(directory.Handle, &directory.Overlapped, &length, FALSE))
+		return false;
+
+	// the buffer overflowed
+	if (length == 0)
+		changed.push_back(directory.Path);
+
+	for (DWORD offset = 0; length > 0;)
+	{
+		const FILE_NOTIFY_INFORMATION* information = (const FILE_NOTIFY_INFORMATION*)(directory.Buffer + offset);
+		fs::path path = directory.Path / std::wstring(information->FileName, information->FileNameLength / sizeof(WCHAR));
+		std::error_code error;
+
+		if (!fs::is_directory(path, error))
+			changed.push_back(path);
+		else if (information->Action == FILE_ACTION_ADDED || information->Action == FILE_ACTION_RENAMED_NEW_NAME)
+			addFiles(path, changed);
+
+		if (information->NextEntryOffset == 0)
+			break;
+
+		offset += information->NextEntryOffset;
+	}
+
+	ResetEvent(directory.Overlapped.hEvent);
+
+	return directory.Read();
+}
+
+#else
+
+FileWatcher::~FileWatcher()
+{
+	if (Handle != -1)
+		close(Handle);
+}
+
+bool FileWatcher::Watch(const std::vector<fs::path>& directories)
+{
+	if (Handle == -1)
+		Handle = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+	if (Handle == -1)
+		return false;
+
+	for (const fs::path& directory : directories)
+	{
+		if (!AddDirectory(directory))
+			return false;
+
+		Roots.push_back(directory);
+	}
+
+	return true;
+}
+
+bool FileWatcher::AddDirectory(const fs::path& directory)
+{
+	// editors write a temporary file and move it over the old one, so IN_MOVED_TO is as much a write as IN_CLOSE_WRITE
+	const uint32_t mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE;
+
+	int watch = inotify_add_watch(Handle, directory.c_str(), mask);
+
+	if (watch == -1)
+		return false;
+
+	Directories[watch] = directory;
+
+	std::error_code error;
+
+	for (const fs::directory_entry& entry : fs::directory_iterator(directory, error))
+		if (entry.is_directory(error) && !AddDirectory(entry.path()))
+			return false;
+
+	return true;
+}
+
+bool FileWatcher::ReadEvents(int timeoutMilliseconds, std::vector<fs::path>& changed)
+{
+	pollfd request = { Handle, POLLIN, 0 };
+
+	int ready = poll(&request, 1, timeoutMilliseconds);
+
+	if (ready == -1)
+		return errno == EINTR;
+
+	alignas(inotify_event) char buffer[1 << 16];
+
+	while (ready > 0)
+	{
+		ssize_t length = read(Handle, buffer, sizeof(buffer));
+
+		if (length <= 0)
+			return length == 0 || errno == EAGAIN || errno == EINTR;
+
+		for (ssize_t offset = 0; offset < length;)
+		{
+			const inotify_event* event = (const inotify_event*)(buffer + offset);
+
+			offset += sizeof(inotify_event) + event->len;
+
+			if (event->mask & IN_Q_OVERFLOW)
+			{
+				changed.insert(changed.end(), Roots.begin(), Roots.end());
+
+				continue;
+			}
+
+			auto directory = Directories.find(event->wd);
+
+			if (directory == Directories.end())
+				continue;
+
+			if (event->mask & IN_IGNORED)
+			{
+				Directories.erase(directory);
+
+				continue;
+			}
+
+			if (event->len == 0)
+				continue;
+
+			fs::path path = directory->second / event->name;
+
+			if (!(event->mask & IN_ISDIR))
+				changed.push_back(path);
+			else if (event->mask & (IN_CREATE | IN_MOVED_TO))
+			{
+				AddDirectory(path);
+				addFiles(path, changed);
+			}
+		}
+	}
+
+	return true;
+}
+
+#endif
\ No newline at end of file
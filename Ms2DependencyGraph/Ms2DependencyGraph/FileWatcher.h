@@ -0,0 +1,45 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// Reports the files written, moved or deleted under a set of directories. Changes are gathered until none have come
+// for a moment, so an editor saving through a temporary file or a checkout touching hundreds of files comes back as
+// one batch. Files in a directory that was moved in are reported too. If the system dropped events, the watched
+// directories themselves are reported, since there is no telling what changed.
+class FileWatcher
+{
+public:
+	FileWatcher() {}
+	FileWatcher(const FileWatcher&) = delete;
+	~FileWatcher();
+
+	FileWatcher& operator=(const FileWatcher&) = delete;
+
+	// each directory and everything under it
+	bool Watch(const std::vector<fs::path>& directories);
+
+	// blocks until something changes and then until nothing has for quietMilliseconds, or a batch has gone on for a
+	// second. changed is sorted with each path once. false if the watch stopped working
+	bool WaitForChanges(int quietMilliseconds, std::vector<fs::path>& changed);
+
+private:
+	// appends what happened within timeoutMilliseconds, or -1 to wait for as long as it takes
+	bool ReadEvents(int timeoutMilliseconds, std::vector<fs::path>& changed);
+
+#ifdef _WIN32
+	struct WatchedDirectory;
+
+	std::vector<std::unique_ptr<WatchedDirectory>> Directories;
+#else
+	int Handle = -1;
+	std::vector<fs::path> Roots;
+	std::unordered_map<int, fs::path> Directories;
+
+	bool AddDirectory(const fs::path& directory);
+#endif
+};
\ No newline at end of file
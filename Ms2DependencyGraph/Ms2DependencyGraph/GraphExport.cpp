@@ -0,0 +1,569 @@
+#include "GraphExport.h"
+
+#include <algorithm>
+#include <charconv>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "XmlParsing.h"
+#include "Deflate.h"
+#include "ThreadPool.h"
+
+namespace
+{
+	struct CompressedChunk
+	{
+		std::string Data;
+		bool Done = false;
+	};
+
+	struct ExportWriter
+	{
+		static constexpr bool KeepsEveryGroup = false;
+
+		std::ofstream OutFile;
+		GraphExportFormat Format = GraphExportFormat::Dot;
+		size_t ChunkSize = 0;
+		std::string Buffer;
+
+		int CompressionLevel = 0;
+		std::mutex Lock;
+		std::condition_variable ChunkCompressed;
+		std::deque<std::shared_ptr<CompressedChunk>> PendingChunks;
+
+		ExportWriter(const fs::path& outputPath, GraphExportFormat format, int compressionLevel, size_t chunkSize) : OutFile(outputPath, std::ofstream::out | std::ofstream::binary), Format(format), ChunkSize(chunkSize), CompressionLevel(compressionLevel)
+		{
+			Buffer.reserve(ChunkSize);
+		}
+
+		~ExportWriter()
+		{
+			Flush();
+			WriteChunks(0);
+		}
+
+		void Flush()
+		{
+			if (CompressionLevel <= 0)
+			{
+				OutFile.write(Buffer.data(), Buffer.size());
+				Buffer.clear();
+
+				return;
+			}
+
+			if (Buffer.size() == 0)
+				return;
+
+			std::shared_ptr<CompressedChunk> chunk = std::make_shared<CompressedChunk>();
+
+			getThreadPool().Queue([this, chunk, text = std::move(Buffer)]()
+			{
+				std::string compressed;
+
+				gzipText(text, CompressionLevel, compressed);
+
+				std::lock_guard<std::mutex> guard(Lock);
+
+				chunk->Data = std::move(compressed);
+				chunk->Done = true;
+
+				ChunkCompressed.notify_all();
+			});
+
+			PendingChunks.push_back(chunk);
+
+			Buffer = std::string();
+			Buffer.reserve(ChunkSize);
+
+			WriteChunks((size_t)getThreadPool().GetThreadCount() * 2);
+		}
+
+		// writes finished chunks in order, waiting on the oldest while more than maxPending are in flight
+		void WriteChunks(size_t maxPending)
+		{
+			std::unique_lock<std::mutex> guard(Lock);
+
+			while (PendingChunks.size() > 0)
+			{
+				std::shared_ptr<CompressedChunk> chunk = PendingChunks.front();
+
+				if (!chunk->Done && PendingChunks.size() <= maxPending)
+					return;
+
+				ChunkCompressed.wait(guard, [&chunk]() { return chunk->Done; });
+
+				OutFile.write(chunk->Data.data(), chunk->Data.size());
+
+				PendingChunks.pop_front();
+			}
+		}
+
+		void Write(std::string_view text)
+		{
+			Buffer.append(text);
+		}
+
+		void Write(int value)
+		{
+			char digits[16] = { 0 };
+
+			Buffer.append(digits, std::to_chars(digits, digits + sizeof(digits), value).ptr);
+		}
+
+		void Write(const ReferenceData& reference)
+		{
+			Write(reference.Type == ReferenceType::Skill ? "skill_" : "effect_");
+			Write(reference.Id);
+
+			if (reference.Level != -1)
+			{
+				Write("_");
+				Write(reference.Level);
+			}
+		}
+
+		void WriteId(const char* prefix, int id)
+		{
+			Write(prefix);
+			Write(id);
+		}
+
+		void EndStatement()
+		{
+			Write("\n");
+
+			if (Buffer.size() >= ChunkSize)
+				Flush();
+		}
+
+		template <typename From, typename To>
+		void Edge(const From& from, const To& to, std::string_view relation)
+		{
+			if (Format == GraphExportFormat::Dot)
+			{
+				Write("\t");
+				WriteNode(from);
+				Write(" -> ");
+				WriteNode(to);
+				Write(" [label=\"");
+				Write(relation);
+				Write("\"]");
+			}
+			else
+			{
+				WriteNode(from);
+				Write("\t");
+				WriteNode(to);
+				Write("\t");
+				Write(relation);
+			}
+
+			EndStatement();
+		}
+
+		void Node(const ReferenceData& reference, const char* kind, std::string_view escapedName, const char* shape)
+		{
+			if (Format != GraphExportFormat::Dot)
+				return;
+
+			Write("\t");
+			Write(reference);
+			Write(" [label=\"");
+			Write(kind);
+			Write(" ");
+			Write(reference.Id);
+
+			if (reference.Level != -1)
+			{
+				Write(" Lv");
+				Write(reference.Level);
+			}
+
+			if (escapedName.size() > 0)
+			{
+				Write("\\n");
+				Write(escapedName);
+			}
+
+			Write("\" shape=");
+			Write(shape);
+			Write("]");
+
+			EndStatement();
+		}
+
+		void Node(const char* prefix, int id, const char* kind, std::string_view escapedName, const char* shape)
+		{
+			if (Format != GraphExportFormat::Dot)
+				return;
+
+			Write("\t");
+			WriteId(prefix, id);
+			Write(" [label=\"");
+			Write(kind);
+			Write(" ");
+			Write(id);
+
+			if (escapedName.size() > 0)
+			{
+				Write("\\n");
+				Write(escapedName);
+			}
+
+			Write("\" shape=");
+			Write(shape);
+			Write("]");
+
+			EndStatement();
+		}
+
+	private:
+		void WriteNode(const ReferenceData& reference)
+		{
+			Write(reference);
+		}
+
+		void WriteNode(const std::pair<const char*, int>& node)
+		{
+			WriteId(node.first, node.second);
+		}
+	};
+
+	template <typename Key, typename Value>
+	std::vector<Key> sortedKeys(const std::unordered_map<Key, Value>& map)
+	{
+		std::vector<Key> keys;
+
+		keys.reserve(map.size());
+
+		for (const auto& entry : map)
+			keys.push_back(entry.first);
+
+		std::sort(keys.begin(), keys.end());
+
+		return keys;
+	}
+
+	// matches GraphData::Dereference: scaling skills and effects are a single node shared by every level
+	ReferenceData normalize(const ReferenceData& reference)
+	{
+		ReferenceData normalized = reference;
+
+		if (reference.Type == ReferenceType::Skill)
+		{
+			auto skillIndex = model().Skills.find(reference.Id);
+
+			if (skillIndex == model().Skills.end() || skillIndex->second.ScalingLevels)
+				normalized.Level = -1;
+		}
+		else
+		{
+			auto effectIndex = model().Effects.find(reference.Id);
+
+			if (effectIndex == model().Effects.end() || effectIndex->second.ScalingLevels)
+				normalized.Level = -1;
+		}
+
+		return normalized;
+	}
+
+	const char* getConditionName(ConditionReferenceType type)
+	{
+		switch (type)
+		{
+		case ConditionReferenceType::Require: return "require";
+		case ConditionReferenceType::Prevent: return "prevent";
+		case ConditionReferenceType::RequireRange: return "require_range";
+		case ConditionReferenceType::Ignore: return "ignore";
+		case ConditionReferenceType::RequireEvent: return "require_event";
+		}
+
+		return "condition";
+	}
+
+	const char* getModificationName(ModifyReferenceType type)
+	{
+		switch (type)
+		{
+		case ModifyReferenceType::Cancel: return "cancel";
+		case ModifyReferenceType::Immune: return "immune";
+		case ModifyReferenceType::ResetCooldown: return "reset_cooldown";
+		case ModifyReferenceType::ModifyDuration: return "modify_duration";
+		case ModifyReferenceType::ModifyStacks: return "modify_stacks";
+		}
+
+		return "modify";
+	}
+
+	template <typename Writer>
+	void exportCondition(Writer& writer, const ReferenceData& owner, const BeginCondition& condition)
+	{
+		for (const TriggerReferenceData& reference : condition.References)
+			writer.Edge(owner, normalize(reference), getConditionName(reference.ConditionType));
+
+		for (int skillId : condition.RequireSkillCodes)
+			writer.Edge(owner, normalize(ReferenceData{ ReferenceType::Skill, skillId, 1 }), "require_skill");
+	}
+
+	template <typename Writer>
+	void exportTrigger(Writer& writer, const ReferenceData& owner, const ConditionSkill& trigger, std::string_view relation)
+	{
+		if (trigger.RandomCasts.size() == 0)
+		{
+			writer.Edge(owner, normalize(trigger.Reference), relation);
+
+			return;
+		}
+
+		for (const ReferenceData& cast : trigger.RandomCasts)
+			writer.Edge(owner, normalize(cast), "random_cast");
+	}
+
+	template <typename Level>
+	std::vector<int> getLevels(bool scalingLevels, const std::unordered_map<int, Level>& levels)
+	{
+		if (scalingLevels)
+			return std::vector<int>{ levels.begin()->first };
+
+		return sortedKeys(levels);
+	}
+
+	template <typename Writer>
+	void exportSkill(Writer& writer, int skillId)
+	{
+		auto index = model().Skills.find(skillId);
+
+		if (index == model().Skills.end())
+			return;
+
+		const SkillData& skill = index->second;
+
+		if (skill.Levels.size() == 0)
+			return;
+
+		for (int level : getLevels(skill.ScalingLevels, skill.Levels))
+		{
+			const SkillLevelData& skillLevel = skill.Levels.find(level)->second;
+			ReferenceData skillRef{ ReferenceType::Skill, skillId, skill.ScalingLevels ? -1 : level };
+
+			writer.Node(skillRef, "Skill", getPooledLabel(skill.EscapedName), "box");
+
+			exportCondition(writer, skillRef, skillLevel.Condition);
+
+			for (const ConditionSkill& passive : skillLevel.Passives)
+				exportTrigger(writer, skillRef, passive, "passive");
+
+			for (const SkillMotion& motion : skillLevel.Motions)
+				for (const SkillAttack& attack : motion.Attacks)
+					for (const ConditionSkill& trigger : attack.Triggers)
+						exportTrigger(writer, skillRef, trigger, "attack");
+
+			if (skillLevel.Combo.OutputSkill.Id != 0)
+				writer.Edge(skillRef, normalize(skillLevel.Combo.OutputSkill), "combo");
+
+			for (const ChangeSkillReference& changeSkill : skillLevel.ChangeSkillReferences)
+				if (changeSkill.Skill.Id != 0)
+					writer.Edge(skillRef, normalize(changeSkill.Skill), "change_skill");
+		}
+	}
+
+	template <typename Writer>
+	void exportSkills(Writer& writer)
+	{
+		for (int skillId : sortedKeys(model().Skills))
+			exportSkill(writer, skillId);
+	}
+
+	template <typename Writer>
+	void exportEffect(Writer& writer, int effectId)
+	{
+		auto index = model().Effects.find(effectId);
+
+		if (index == model().Effects.end())
+			return;
+
+		const AdditionalEffectData& effect = index->second;
+
+		if (effect.Levels.size() == 0)
+			return;
+
+		for (int level : getLevels(effect.ScalingLevels, effect.Levels))
+		{
+			const AdditionalEffectLevelData& effectLevel = effect.Levels.find(level)->second;
+			ReferenceData effectRef{ ReferenceType::Effect, effectId, effect.ScalingLevels ? -1 : level };
+
+			writer.Node(effectRef, "Effect", getPooledLabel(effectLevel.EscapedName), "ellipse");
+
+			exportCondition(writer, effectRef, effectLevel.Condition);
+
+			for (const ConditionSkill& trigger : effectLevel.Triggers)
+				exportTrigger(writer, effectRef, trigger, "trigger");
+
+			for (const ModifyReference& mod : effectLevel.Modifications)
+				writer.Edge(effectRef, normalize(mod), getModificationName(mod.ModificationType));
+
+			// the index keeps groups that aren't an effect as well, so one being added reaches the effects in its group
+			if (effectLevel.Group != 0 && (Writer::KeepsEveryGroup || model().Effects.contains(effectLevel.Group)))
+				writer.Edge(effectRef, normalize(ReferenceData{ ReferenceType::Effect, effectLevel.Group, -1 }), "group");
+		}
+	}
+
+	template <typename Writer>
+	void exportEffects(Writer& writer)
+	{
+		for (int effectId : sortedKeys(model().Effects))
+			exportEffect(writer, effectId);
+	}
+
+	template <typename Writer>
+	void exportItem(Writer& writer, int itemId)
+	{
+		auto index = model().Items.find(itemId);
+
+		if (index == model().Items.end())
+			return;
+
+		const ItemData& item = index->second;
+
+		writer.Node("item_", itemId, "Item", getPooledLabel(item.EscapedName), "component");
+
+		for (const ReferenceData& effect : item.AdditionalEffects)
+			writer.Edge(std::make_pair("item_", itemId), normalize(effect), "effect");
+
+		for (const ReferenceData& skill : item.Skills)
+			writer.Edge(std::make_pair("item_", itemId), normalize(skill), "skill");
+	}
+
+	template <typename Writer>
+	void exportItems(Writer& writer)
+	{
+		for (int itemId : sortedKeys(model().Items))
+			exportItem(writer, itemId);
+	}
+
+	template <typename Writer>
+	void exportSetBonus(Writer& writer, int setId)
+	{
+		auto index = model().SetBonuses.find(setId);
+
+		if (index == model().SetBonuses.end())
+			return;
+
+		const SetBonusData& setData = index->second;
+
+		writer.Node("set_", setId, "Set", Sanitize(Desanitize(setData.Name)), "folder");
+
+		for (int itemId : setData.ItemIds)
+			writer.Edge(std::make_pair("set_", setId), std::make_pair("item_", itemId), "item");
+
+		if (setData.OptionData == nullptr)
+			return;
+
+		for (const SetBonusOptionPartData& part : setData.OptionData->Parts)
+		{
+			std::string relation = std::to_string(part.Count) + "_set";
+
+			for (const ReferenceData& effect : part.AdditionalEffects)
+				writer.Edge(std::make_pair("set_", setId), normalize(effect), relation);
+		}
+	}
+
+	template <typename Writer>
+	void exportSetBonuses(Writer& writer)
+	{
+		for (int setId : sortedKeys(model().SetBonuses))
+			exportSetBonus(writer, setId);
+	}
+	// Stands in for ExportWriter to hand the edges to a callback instead of writing them.
+	struct EdgeCollector
+	{
+		static constexpr bool KeepsEveryGroup = true;
+
+		const std::function<void(const GraphNodeId& from, const GraphNodeId& to)>& Callback;
+
+		template <typename From, typename To>
+		void Edge(const From& from, const To& to, std::string_view)
+		{
+			Callback(GetNode(from), GetNode(to));
+		}
+
+		void Node(const ReferenceData&, const char*, std::string_view, const char*) {}
+		void Node(const char*, int, const char*, std::string_view, const char*) {}
+
+	private:
+		GraphNodeId GetNode(const ReferenceData& reference)
+		{
+			return GraphNodeId{ reference.Type == ReferenceType::Skill ? GraphNodeType::Skill : GraphNodeType::Effect, reference.Id };
+		}
+
+		GraphNodeId GetNode(const std::pair<const char*, int>& node)
+		{
+			return GraphNodeId{ strcmp(node.first, "set_") == 0 ? GraphNodeType::SetBonus : GraphNodeType::Item, node.second };
+		}
+	};
+}
+
+void exportGraph(const fs::path& outputPath, GraphExportFormat format, int compressionLevel, size_t chunkSize)
+{
+	if (outputPath.has_parent_path())
+		fs::create_directories(outputPath.parent_path());
+
+	ExportWriter writer(outputPath, format, compressionLevel, chunkSize);
+
+	if (format == GraphExportFormat::Dot)
+		writer.Write("digraph Everything {\n");
+
+	exportSkills(writer);
+	exportEffects(writer);
+	exportItems(writer);
+	exportSetBonuses(writer);
+
+	if (format == GraphExportFormat::Dot)
+		writer.Write("}\n");
+}
+
+void forEachExportEdge(const std::function<void(const GraphNodeId& from, const GraphNodeId& to)>& edge)
+{
+	EdgeCollector collector{ edge };
+
+	exportSkills(collector);
+	exportEffects(collector);
+	exportItems(collector);
+	exportSetBonuses(collector);
+}
+
+void forEachExportEdge(const GraphNodeId& node, const std::function<void(const GraphNodeId& from, const GraphNodeId& to)>& edge)
+{
+	EdgeCollector collector{ edge };
+
+	switch (node.Type)
+	{
+	case GraphNodeType::Skill:
+		exportSkill(collector, node.Id);
+		break;
+
+	case GraphNodeType::Effect:
+		exportEffect(collector, node.Id);
+		break;
+
+	case GraphNodeType::Item:
+		exportItem(collector, node.Id);
+		break;
+
+	case GraphNodeType::SetBonus:
+		exportSetBonus(collector, node.Id);
+		break;
+
+	default:
+		break;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <filesystem>
+#include <functional>
+
+namespace fs = std::filesystem;
+
+enum class GraphExportFormat
+{
+	Dot,
+	EdgeList
+};
+
+// Writes every skill, effect, item and set bonus as one graph, walked in id order. Output goes through a fixed size
+// buffer that is flushed as it fills, so memory use does not grow with the dataset. The edge list format is one
+// "from<TAB>to<TAB>relation" line per edge. With a compression level each chunk is gzipped on the thread pool as its
+// own member, and the members are written in order.
+void exportGraph(const fs::path& outputPath, GraphExportFormat format, int compressionLevel = 0, size_t chunkSize = 1 << 20);
+
+enum class GraphNodeType
+{
+	Skill,
+	Effect,
+	Item,
+	SetBonus,
+	Job
+};
+
+// A node of the exported graph with its level dropped.
+struct GraphNodeId
+{
+	GraphNodeType Type = GraphNodeType::Skill;
+	int Id = 0;
+
+	bool operator==(const GraphNodeId& other) const { return Type == other.Type && Id == other.Id; }
+};
+
+// Calls edge for each edge exportGraph would write, in the same order, plus edges to effect groups that aren't an
+// effect themselves.
+void forEachExportEdge(const std::function<void(const GraphNodeId& from, const GraphNodeId& to)>& edge);
+
+// Just the edges out of node. Jobs aren't exported, so they have none.
+void forEachExportEdge(const GraphNodeId& node, const std::function<void(const GraphNodeId& from, const GraphNodeId& to)>& edge);
\ No newline at end of file
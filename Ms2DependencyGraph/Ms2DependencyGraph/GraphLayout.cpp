@@ -0,0 +1,931 @@
+#include "GraphLayout.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <unordered_map>
+
+namespace
+{
+	const float CharacterWidth = 7;
+	const float LineHeight = 16;
+	const float Margin = 8;
+
+	std::string unescapeGraphString(std::string_view text)
+	{
+		std::string output;
+
+		output.reserve(text.size());
+
+		for (size_t i = 0; i < text.size(); ++i)
+		{
+			if (text[i] == '\\' && i + 1 < text.size())
+			{
+				char escaped = text[++i];
+
+				if (escaped == 'n' || escaped == 'l' || escaped == 'r')
+					output.push_back('\n');
+				else
+					output.push_back(escaped);
+
+				continue;
+			}
+
+			output.push_back(text[i] == '\t' ? ' ' : text[i]);
+		}
+
+		return output;
+	}
+
+	void splitLabel(std::string_view text, std::vector<std::string>& lines)
+	{
+		lines.clear();
+
+		std::string label = unescapeGraphString(text);
+
+		size_t start = 0;
+
+		while (start <= label.size())
+		{
+			size_t end = label.find('\n', start);
+
+			if (end == std::string::npos)
+				end = label.size();
+
+			lines.push_back(label.substr(start, end - start));
+
+			start = end + 1;
+		}
+
+		while (lines.size() > 1 && lines.back().size() == 0)
+			lines.pop_back();
+	}
+
+	bool findAttribute(const std::vector<GraphAttribute>& attributes, std::string_view name, std::string_view& value)
+	{
+		for (const GraphAttribute& attribute : attributes)
+		{
+			if (attribute.Name != name)
+				continue;
+
+			value = attribute.Value;
+
+			return true;
+		}
+
+		return false;
+	}
+
+	bool isRounded(std::string_view shape)
+	{
+		return shape == "ellipse" || shape == "egg" || shape == "Mcircle" || shape == "circle";
+	}
+
+	std::string_view svgColor(std::string_view color)
+	{
+		if (color.size() == 0)
+			return "black";
+
+		if (color == "chartreuse4")
+			return "#458b00";
+
+		return color;
+	}
+
+	// Escapes text for XML while keeping character and entity references such as the &#013; tooltip line breaks intact.
+	void writeXmlText(std::ostream& out, std::string_view text)
+	{
+		for (size_t i = 0; i < text.size(); ++i)
+		{
+			char character = text[i];
+
+			if (character == '&')
+			{
+				size_t end = i + 1;
+
+				if (end < text.size() && text[end] == '#')
+					++end;
+
+				while (end < text.size() && end - i < 10 && isalnum((unsigned char)text[end]))
+					++end;
+
+				bool isReference = end < text.size() && text[end] == ';' && end > i + 1;
+
+				if (!isReference)
+				{
+					out << "&amp;";
+
+					continue;
+				}
+
+				out << text.substr(i, end - i + 1);
+
+				i = end;
+
+				continue;
+			}
+
+			if (character == '<')
+				out << "&lt;";
+			else if (character == '>')
+				out << "&gt;";
+			else if (character == '"')
+				out << "&quot;";
+			else
+				out << character;
+		}
+	}
+
+	struct Point
+	{
+		float X = 0;
+		float Y = 0;
+	};
+
+	Point clipToNode(const GraphLayout::Node& node, Point target)
+	{
+		float dx = target.X - node.X;
+		float dy = target.Y - node.Y;
+
+		if (node.IsDummy || (dx == 0 && dy == 0))
+			return Point{ node.X, node.Y };
+
+		float halfWidth = node.Width / 2;
+		float halfHeight = node.Height / 2;
+		float scale = 0;
+
+		if (isRounded(node.Shape))
+			scale = 1 / std::sqrt((dx * dx) / (halfWidth * halfWidth) + (dy * dy) / (halfHeight * halfHeight));
+		else
+			scale = std::min(dx != 0 ? halfWidth / std::abs(dx) : 1e9f, dy != 0 ? halfHeight / std::abs(dy) : 1e9f);
+
+		scale = std::min(scale, 1.f);
+
+		return Point{ node.X + dx * scale, node.Y + dy * scale };
+	}
+
+	void writePoints(std::ostream& out, const std::vector<Point>& points)
+	{
+		for (size_t i = 0; i < points.size(); ++i)
+			out << (i == 0 ? "" : " ") << points[i].X << "," << points[i].Y;
+	}
+
+	void writeLines(std::ostream& out, const std::vector<std::string>& lines, float x, float y)
+	{
+		float baseline = y - (lines.size() - 1) * LineHeight / 2 + 5;
+
+		for (size_t i = 0; i < lines.size(); ++i)
+		{
+			out << "<text text-anchor=\"middle\" x=\"" << x << "\" y=\"" << (baseline + i * LineHeight) << "\" font-family=\"Times,serif\" font-size=\"14.00\">";
+
+			writeXmlText(out, lines[i]);
+
+			out << "</text>\n";
+		}
+	}
+
+	void writeShape(std::ostream& out, const GraphLayout::Node& node)
+	{
+		std::string_view stroke = svgColor(node.Color);
+
+		float left = node.X - node.Width / 2;
+		float right = node.X + node.Width / 2;
+		float top = node.Y - node.Height / 2;
+		float bottom = node.Y + node.Height / 2;
+
+		const auto polygon = [&out, stroke](const std::vector<Point>& points)
+		{
+			out << "<polygon fill=\"none\" stroke=\"" << stroke << "\" points=\"";
+
+			writePoints(out, points);
+
+			out << "\"/>\n";
+		};
+
+		const auto rectangle = [&out, stroke](float x, float y, float width, float height)
+		{
+			out << "<rect fill=\"none\" stroke=\"" << stroke << "\" x=\"" << x << "\" y=\"" << y << "\" width=\"" << width << "\" height=\"" << height << "\"/>\n";
+		};
+
+		if (node.Shape == "box" || node.Shape == "rect" || node.Shape == "rectangle")
+			rectangle(left, top, node.Width, node.Height);
+		else if (node.Shape == "box3d")
+		{
+			rectangle(left, top + 4, node.Width - 4, node.Height - 4);
+
+			out << "<polyline fill=\"none\" stroke=\"" << stroke << "\" points=\"" << left << "," << (top + 4) << " " << (left + 4) << "," << top << " " << right << "," << top << " " << right << "," << (bottom - 4) << " " << (right - 4) << "," << bottom << "\"/>\n";
+			out << "<polyline fill=\"none\" stroke=\"" << stroke << "\" points=\"" << (right - 4) << "," << (top + 4) << " " << right << "," << top << "\"/>\n";
+		}
+		else if (node.Shape == "hexagon")
+			polygon({ { left, node.Y }, { left + 12, top }, { right - 12, top }, { right, node.Y }, { right - 12, bottom }, { left + 12, bottom } });
+		else if (node.Shape == "octagon")
+			polygon({ { left, top + 10 }, { left + 10, top }, { right - 10, top }, { right, top + 10 }, { right, bottom - 10 }, { right - 10, bottom }, { left + 10, bottom }, { left, bottom - 10 } });
+		else if (node.Shape == "house")
+			polygon({ { left, bottom }, { right, bottom }, { right, top + node.Height * 0.35f }, { node.X, top }, { left, top + node.Height * 0.35f } });
+		else if (node.Shape == "invhouse")
+			polygon({ { left, top }, { right, top }, { right, bottom - node.Height * 0.35f }, { node.X, bottom }, { left, bottom - node.Height * 0.35f } });
+		else if (node.Shape == "component")
+		{
+			rectangle(left, top, node.Width, node.Height);
+			rectangle(left - 4, top + 6, 8, 5);
+			rectangle(left - 4, bottom - 11, 8, 5);
+		}
+		else if (node.Shape == "folder")
+			polygon({ { left, top + 5 }, { left + 4, top }, { left + 24, top }, { left + 28, top + 5 }, { right, top + 5 }, { right, bottom }, { left, bottom } });
+		else if (node.Shape == "Mcircle" || node.Shape == "circle")
+		{
+			float radius = node.Width / 2;
+
+			out << "<ellipse fill=\"none\" stroke=\"" << stroke << "\" cx=\"" << node.X << "\" cy=\"" << node.Y << "\" rx=\"" << radius << "\" ry=\"" << radius << "\"/>\n";
+
+			if (node.Shape == "Mcircle")
+			{
+				float chordY = radius * 0.7f;
+				float chordX = radius * 0.71f;
+
+				out << "<polyline fill=\"none\" stroke=\"" << stroke << "\" points=\"" << (node.X - chordX) << "," << (node.Y - chordY) << " " << (node.X + chordX) << "," << (node.Y - chordY) << "\"/>\n";
+				out << "<polyline fill=\"none\" stroke=\"" << stroke << "\" points=\"" << (node.X - chordX) << "," << (node.Y + chordY) << " " << (node.X + chordX) << "," << (node.Y + chordY) << "\"/>\n";
+			}
+		}
+		else if (node.Shape != "none" && node.Shape != "plaintext")
+			out << "<ellipse fill=\"none\" stroke=\"" << stroke << "\" cx=\"" << node.X << "\" cy=\"" << node.Y << "\" rx=\"" << (node.Width / 2) << "\" ry=\"" << (node.Height / 2) << "\"/>\n";
+	}
+
+	void writeArrowHead(std::ostream& out, std::string_view arrowHead, std::string_view stroke, Point tip, Point direction)
+	{
+		Point normal{ -direction.Y, direction.X };
+
+		if (arrowHead == "none")
+			return;
+
+		if (arrowHead == "dot")
+		{
+			out << "<ellipse fill=\"" << stroke << "\" stroke=\"" << stroke << "\" cx=\"" << (tip.X - direction.X * 4) << "\" cy=\"" << (tip.Y - direction.Y * 4) << "\" rx=\"4\" ry=\"4\"/>\n";
+
+			return;
+		}
+
+		if (arrowHead == "tee")
+		{
+			Point center{ tip.X - direction.X * 2, tip.Y - direction.Y * 2 };
+
+			out << "<polyline fill=\"none\" stroke=\"" << stroke << "\" stroke-width=\"2\" points=\"" << (center.X + normal.X * 5) << "," << (center.Y + normal.Y * 5) << " " << (center.X - normal.X * 5) << "," << (center.Y - normal.Y * 5) << "\"/>\n";
+
+			return;
+		}
+
+		Point base{ tip.X - direction.X * 10, tip.Y - direction.Y * 10 };
+
+		out << "<polygon fill=\"" << (arrowHead.size() > 0 && arrowHead[0] == 'o' ? "none" : stroke) << "\" stroke=\"" << stroke << "\" points=\"";
+
+		if (arrowHead == "vee")
+			writePoints(out, { tip, { base.X + normal.X * 4, base.Y + normal.Y * 4 }, { tip.X - direction.X * 6, tip.Y - direction.Y * 6 }, { base.X - normal.X * 4, base.Y - normal.Y * 4 } });
+		else
+			writePoints(out, { tip, { base.X + normal.X * 3.5f, base.Y + normal.Y * 3.5f }, { base.X - normal.X * 3.5f, base.Y - normal.Y * 3.5f } });
+
+		out << "\"/>\n";
+	}
+}
+
+void GraphLayout::Build(const GraphText& graph)
+{
+	Name = graph.Name;
+	Nodes.clear();
+	Edges.clear();
+	Ranks.clear();
+
+	std::unordered_map<std::string_view, int> nodeIndices;
+
+	const auto getNode = [this, &nodeIndices](std::string_view id)
+	{
+		auto [index, inserted] = nodeIndices.try_emplace(id, (int)Nodes.size());
+
+		if (inserted)
+		{
+			Nodes.push_back(Node{});
+			Nodes.back().Id = id;
+			Nodes.back().Label.push_back(std::string(id));
+		}
+
+		return index->second;
+	};
+
+	std::vector<GraphAttribute> attributes;
+	std::string_view value;
+
+	for (const GraphStatement& statement : graph.Statements)
+	{
+		readGraphAttributes(statement.Attributes, attributes);
+
+		if (!statement.IsEdge())
+		{
+			Node& node = Nodes[getNode(statement.From)];
+
+			if (findAttribute(attributes, "label", value))
+				splitLabel(value, node.Label);
+
+			if (findAttribute(attributes, "tooltip", value))
+				node.Tooltip = unescapeGraphString(value);
+
+			node.Shape = findGraphAttribute(attributes, "shape", node.Shape);
+			node.Color = findGraphAttribute(attributes, "color", node.Color);
+			node.Url = findGraphAttribute(attributes, "URL", node.Url);
+
+			continue;
+		}
+
+		Edge edge;
+
+		edge.From = getNode(statement.From);
+		edge.To = getNode(statement.To);
+		edge.Color = findGraphAttribute(attributes, "color");
+		edge.Style = findGraphAttribute(attributes, "style");
+		edge.ArrowHead = findGraphAttribute(attributes, "arrowhead", "normal");
+		edge.Directed = findGraphAttribute(attributes, "dir") != "none";
+		edge.Constraint = findGraphAttribute(attributes, "constraint") != "false" && edge.From != edge.To;
+
+		if (findAttribute(attributes, "label", value))
+			splitLabel(value, edge.Label);
+
+		Edges.push_back(std::move(edge));
+	}
+
+	for (Node& node : Nodes)
+	{
+		size_t longestLine = 0;
+
+		for (const std::string& line : node.Label)
+			longestLine = std::max(longestLine, line.size());
+
+		node.Width = std::max(54.f, longestLine * CharacterWidth + 16);
+		node.Height = std::max(36.f, node.Label.size() * LineHeight + 12);
+
+		if (isRounded(node.Shape))
+		{
+			node.Width *= 1.3f;
+			node.Height *= 1.3f;
+		}
+
+		if (node.Shape == "Mcircle" || node.Shape == "circle")
+			node.Width = node.Height = std::max(node.Width, node.Height);
+		else if (node.Shape == "hexagon" || node.Shape == "octagon")
+			node.Width += 24;
+		else if (node.Shape == "house" || node.Shape == "invhouse")
+			node.Height += node.Height * 0.35f;
+	}
+}
+
+void GraphLayout::Layout()
+{
+	AssignRanks();
+	InsertDummyNodes();
+	ReduceCrossings();
+	AssignCoordinates();
+}
+
+void GraphLayout::AssignRanks()
+{
+	int nodeCount = (int)Nodes.size();
+
+	std::vector<std::vector<int>> outgoing(nodeCount);
+
+	for (int i = 0; i < (int)Edges.size(); ++i)
+		if (Edges[i].Constraint)
+			outgoing[Edges[i].From].push_back(i);
+
+	// depth first search from every unvisited node in statement order, reversing edges that close a cycle
+	std::vector<char> state(nodeCount, 0);
+	std::vector<std::pair<int, size_t>> stack;
+
+	for (int start = 0; start < nodeCount; ++start)
+	{
+		if (state[start] != 0)
+			continue;
+
+		state[start] = 1;
+		stack.push_back({ start, 0 });
+
+		while (stack.size() > 0)
+		{
+			auto& [node, nextEdge] = stack.back();
+
+			if (nextEdge < outgoing[node].size())
+			{
+				Edge& edge = Edges[outgoing[node][nextEdge++]];
+
+				if (state[edge.To] == 1)
+					edge.Reversed = true;
+				else if (state[edge.To] == 0)
+				{
+					state[edge.To] = 1;
+					stack.push_back({ edge.To, 0 });
+				}
+
+				continue;
+			}
+
+			state[node] = 2;
+			stack.pop_back();
+		}
+	}
+
+	std::vector<std::vector<int>> children(nodeCount);
+	std::vector<int> incoming(nodeCount, 0);
+
+	for (const Edge& edge : Edges)
+	{
+		if (!edge.Constraint)
+			continue;
+
+		int top = edge.Reversed ? edge.To : edge.From;
+		int bottom = edge.Reversed ? edge.From : edge.To;
+
+		children[top].push_back(bottom);
+		++incoming[bottom];
+	}
+
+	std::vector<int> queue;
+	std::vector<char> hasParent(nodeCount, 0);
+
+	for (int i = 0; i < nodeCount; ++i)
+	{
+		Nodes[i].Rank = 0;
+		hasParent[i] = incoming[i] > 0;
+
+		if (incoming[i] == 0)
+			queue.push_back(i);
+	}
+
+	for (size_t i = 0; i < queue.size(); ++i)
+	{
+		int node = queue[i];
+
+		for (int child : children[node])
+		{
+			Nodes[child].Rank = std::max(Nodes[child].Rank, Nodes[node].Rank + 1);
+
+			if (--incoming[child] == 0)
+				queue.push_back(child);
+		}
+	}
+
+	// sources such as the lapenshard hub sit directly above their closest child instead of at the top
+	for (int i = 0; i < nodeCount; ++i)
+	{
+		if (i == 0 || hasParent[i] || children[i].size() == 0)
+			continue;
+
+		int closestChild = Nodes[children[i][0]].Rank;
+
+		for (int child : children[i])
+			closestChild = std::min(closestChild, Nodes[child].Rank);
+
+		Nodes[i].Rank = std::max(Nodes[i].Rank, closestChild - 1);
+	}
+}
+
+void GraphLayout::InsertDummyNodes()
+{
+	UpperNeighbors.assign(Nodes.size(), std::vector<int>());
+	LowerNeighbors.assign(Nodes.size(), std::vector<int>());
+
+	for (Edge& edge : Edges)
+	{
+		edge.Chain.clear();
+
+		if (!edge.Constraint)
+			continue;
+
+		int top = edge.Reversed ? edge.To : edge.From;
+		int bottom = edge.Reversed ? edge.From : edge.To;
+		int previous = top;
+
+		for (int rank = Nodes[top].Rank + 1; rank < Nodes[bottom].Rank; ++rank)
+		{
+			Node dummy;
+
+			dummy.IsDummy = true;
+			dummy.Rank = rank;
+			dummy.Width = 8;
+			dummy.Height = 0;
+			dummy.Label.clear();
+
+			int index = (int)Nodes.size();
+
+			Nodes.push_back(dummy);
+			UpperNeighbors.push_back({ previous });
+			LowerNeighbors.push_back({});
+			LowerNeighbors[previous].push_back(index);
+
+			edge.Chain.push_back(index);
+			previous = index;
+		}
+
+		LowerNeighbors[previous].push_back(bottom);
+		UpperNeighbors[bottom].push_back(previous);
+	}
+
+	int rankCount = 0;
+
+	for (const Node& node : Nodes)
+		rankCount = std::max(rankCount, node.Rank + 1);
+
+	Ranks.assign(rankCount, std::vector<int>());
+
+	// initial order follows a depth first walk so subtrees start out next to each other
+	std::vector<char> visited(Nodes.size(), 0);
+	std::vector<int> stack;
+
+	for (int start = 0; start < (int)Nodes.size(); ++start)
+	{
+		if (visited[start] || UpperNeighbors[start].size() > 0)
+			continue;
+
+		stack.push_back(start);
+
+		while (stack.size() > 0)
+		{
+			int node = stack.back();
+
+			stack.pop_back();
+
+			if (visited[node])
+				continue;
+
+			visited[node] = 1;
+			Nodes[node].Order = (int)Ranks[Nodes[node].Rank].size();
+			Ranks[Nodes[node].Rank].push_back(node);
+
+			for (auto child = LowerNeighbors[node].rbegin(); child != LowerNeighbors[node].rend(); ++child)
+				if (!visited[*child])
+					stack.push_back(*child);
+		}
+	}
+
+	for (int i = 0; i < (int)Nodes.size(); ++i)
+	{
+		if (visited[i])
+			continue;
+
+		Nodes[i].Order = (int)Ranks[Nodes[i].Rank].size();
+		Ranks[Nodes[i].Rank].push_back(i);
+	}
+}
+
+long long GraphLayout::CountCrossings() const
+{
+	long long crossings = 0;
+
+	std::vector<std::pair<int, int>> segments;
+	std::vector<int> tree;
+
+	for (size_t rank = 0; rank + 1 < Ranks.size(); ++rank)
+	{
+		segments.clear();
+
+		for (int node : Ranks[rank])
+			for (int lower : LowerNeighbors[node])
+				segments.push_back({ Nodes[node].Order, Nodes[lower].Order });
+
+		std::sort(segments.begin(), segments.end());
+
+		int size = (int)Ranks[rank + 1].size();
+
+		tree.assign(size + 1, 0);
+
+		int inserted = 0;
+
+		for (const auto& segment : segments)
+		{
+			int notGreater = 0;
+
+			for (int i = segment.second + 1; i > 0; i -= i & -i)
+				notGreater += tree[i];
+
+			crossings += inserted - notGreater;
+
+			for (int i = segment.second + 1; i <= size; i += i & -i)
+				++tree[i];
+
+			++inserted;
+		}
+	}
+
+	return crossings;
+}
+
+void GraphLayout::ReduceCrossings()
+{
+	std::vector<std::vector<int>> bestRanks = Ranks;
+	long long bestCrossings = CountCrossings();
+	std::vector<std::pair<float, int>> keys;
+
+	const auto reorder = [this, &keys](std::vector<int>& rank, const std::vector<std::vector<int>>& neighbors)
+	{
+		keys.clear();
+
+		for (int node : rank)
+		{
+			const std::vector<int>& adjacent = neighbors[node];
+
+			float key = (float)Nodes[node].Order;
+
+			if (adjacent.size() > 0)
+			{
+				float total = 0;
+
+				for (int neighbor : adjacent)
+					total += Nodes[neighbor].Order;
+
+				key = total / adjacent.size();
+			}
+
+			keys.push_back({ key, node });
+		}
+
+		std::stable_sort(keys.begin(), keys.end(), [](const auto& left, const auto& right) { return left.first < right.first; });
+
+		for (int i = 0; i < (int)keys.size(); ++i)
+		{
+			rank[i] = keys[i].second;
+			Nodes[rank[i]].Order = i;
+		}
+	};
+
+	for (int sweep = 0; sweep < Settings.CrossingSweeps && bestCrossings > 0; ++sweep)
+	{
+		if (sweep % 2 == 0)
+		{
+			for (size_t rank = 1; rank < Ranks.size(); ++rank)
+				reorder(Ranks[rank], UpperNeighbors);
+		}
+		else
+		{
+			for (size_t rank = Ranks.size() - 1; rank-- > 0;)
+				reorder(Ranks[rank], LowerNeighbors);
+		}
+
+		long long crossings = CountCrossings();
+
+		if (crossings < bestCrossings)
+		{
+			bestCrossings = crossings;
+			bestRanks = Ranks;
+		}
+	}
+
+	Ranks = bestRanks;
+
+	for (const std::vector<int>& rank : Ranks)
+		for (int i = 0; i < (int)rank.size(); ++i)
+			Nodes[rank[i]].Order = i;
+}
+
+void GraphLayout::AssignCoordinates()
+{
+	float y = Margin;
+
+	for (const std::vector<int>& rank : Ranks)
+	{
+		float rankHeight = 0;
+
+		for (int node : rank)
+			rankHeight = std::max(rankHeight, Nodes[node].Height);
+
+		for (int node : rank)
+			Nodes[node].Y = y + rankHeight / 2;
+
+		y += rankHeight + Settings.RankSeparation;
+	}
+
+	Height = y - Settings.RankSeparation + Margin;
+
+	for (const std::vector<int>& rank : Ranks)
+	{
+		float x = 0;
+
+		for (int node : rank)
+		{
+			Nodes[node].X = x + Nodes[node].Width / 2;
+			x += Nodes[node].Width + Settings.NodeSeparation;
+		}
+	}
+
+	std::vector<float> desired;
+	std::vector<float> left;
+	std::vector<float> right;
+
+	// pull nodes toward the mean of their neighbors, then resolve overlaps by averaging a left and a right packing
+	const auto place = [&](const std::vector<int>& rank, const std::vector<std::vector<int>>& neighbors)
+	{
+		int count = (int)rank.size();
+
+		if (count == 0)
+			return;
+
+		desired.resize(count);
+		left.resize(count);
+		right.resize(count);
+
+		for (int i = 0; i < count; ++i)
+		{
+			const std::vector<int>& adjacent = neighbors[rank[i]];
+
+			desired[i] = Nodes[rank[i]].X;
+
+			if (adjacent.size() == 0)
+				continue;
+
+			float total = 0;
+
+			for (int neighbor : adjacent)
+				total += Nodes[neighbor].X;
+
+			desired[i] = total / adjacent.size();
+		}
+
+		const auto separation = [&](int i)
+		{
+			return (Nodes[rank[i]].Width + Nodes[rank[i + 1]].Width) / 2 + Settings.NodeSeparation;
+		};
+
+		left[0] = desired[0];
+
+		for (int i = 1; i < count; ++i)
+			left[i] = std::max(desired[i], left[i - 1] + separation(i - 1));
+
+		right[count - 1] = desired[count - 1];
+
+		for (int i = count - 2; i >= 0; --i)
+			right[i] = std::min(desired[i], right[i + 1] - separation(i));
+
+		for (int i = 0; i < count; ++i)
+			Nodes[rank[i]].X = (left[i] + right[i]) / 2;
+	};
+
+	for (int iteration = 0; iteration < Settings.CoordinateIterations; ++iteration)
+	{
+		if (iteration % 2 == 0)
+		{
+			for (size_t rank = 1; rank < Ranks.size(); ++rank)
+				place(Ranks[rank], UpperNeighbors);
+		}
+		else
+		{
+			for (size_t rank = Ranks.size() - 1; rank-- > 0;)
+				place(Ranks[rank], LowerNeighbors);
+		}
+	}
+
+	float minimum = 0;
+	float maximum = 0;
+	bool first = true;
+
+	for (const Node& node : Nodes)
+	{
+		if (first || node.X - node.Width / 2 < minimum)
+			minimum = node.X - node.Width / 2;
+
+		if (first || node.X + node.Width / 2 > maximum)
+			maximum = node.X + node.Width / 2;
+
+		first = false;
+	}
+
+	for (Node& node : Nodes)
+		node.X += Margin - minimum;
+
+	Width = maximum - minimum + 2 * Margin;
+}
+
+void GraphLayout::WriteSvg(std::ostream& out) const
+{
+	out << "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"?>\n";
+	out << "<svg width=\"" << std::ceil(Width) << "pt\" height=\"" << std::ceil(Height) << "pt\" viewBox=\"0.00 0.00 " << Width << " " << Height << "\" xmlns=\"http://www.w3.org/2000/svg\" xmlns:xlink=\"http://www.w3.org/1999/xlink\">\n";
+	out << "<g id=\"graph0\" class=\"graph\">\n<title>";
+
+	writeXmlText(out, Name);
+
+	out << "</title>\n";
+	out << "<rect fill=\"white\" stroke=\"none\" x=\"0\" y=\"0\" width=\"" << Width << "\" height=\"" << Height << "\"/>\n";
+
+	std::vector<Point> points;
+
+	for (const Edge& edge : Edges)
+	{
+		const Node& from = Nodes[edge.From];
+		const Node& to = Nodes[edge.To];
+
+		points.clear();
+		points.push_back(Point{ from.X, from.Y });
+
+		if (edge.Reversed)
+			for (auto dummy = edge.Chain.rbegin(); dummy != edge.Chain.rend(); ++dummy)
+				points.push_back(Point{ Nodes[*dummy].X, Nodes[*dummy].Y });
+		else
+			for (int dummy : edge.Chain)
+				points.push_back(Point{ Nodes[dummy].X, Nodes[dummy].Y });
+
+		points.push_back(Point{ to.X, to.Y });
+
+		if (edge.From == edge.To)
+		{
+			points.clear();
+			points.push_back(Point{ from.X + from.Width / 2, from.Y - 6 });
+			points.push_back(Point{ from.X + from.Width / 2 + 18, from.Y });
+			points.push_back(Point{ from.X + from.Width / 2, from.Y + 6 });
+		}
+		else
+		{
+			points.front() = clipToNode(from, points[1]);
+			points.back() = clipToNode(to, points[points.size() - 2]);
+		}
+
+		std::string_view stroke = svgColor(edge.Color);
+
+		Point tip = points.back();
+		Point previous = points[points.size() - 2];
+		float length = std::sqrt((tip.X - previous.X) * (tip.X - previous.X) + (tip.Y - previous.Y) * (tip.Y - previous.Y));
+		Point direction{ 0, 1 };
+
+		if (length > 0)
+			direction = Point{ (tip.X - previous.X) / length, (tip.Y - previous.Y) / length };
+
+		bool drawArrow = edge.Directed && edge.ArrowHead != "none";
+
+		if (drawArrow && length > 10)
+			points.back() = Point{ tip.X - direction.X * (edge.ArrowHead == "tee" ? 2 : 8), tip.Y - direction.Y * (edge.ArrowHead == "tee" ? 2 : 8) };
+
+		out << "<g class=\"edge\">\n<title>";
+
+		writeXmlText(out, from.Id);
+
+		out << "&#45;&gt;";
+
+		writeXmlText(out, to.Id);
+
+		out << "</title>\n<path fill=\"none\" stroke=\"" << stroke << "\"";
+
+		if (edge.Style == "dashed")
+			out << " stroke-dasharray=\"5,2\"";
+		else if (edge.Style == "dotted")
+			out << " stroke-dasharray=\"1,5\"";
+
+		out << " d=\"";
+
+		for (size_t i = 0; i < points.size(); ++i)
+			out << (i == 0 ? "M" : " L") << points[i].X << "," << points[i].Y;
+
+		out << "\"/>\n";
+
+		if (drawArrow)
+			writeArrowHead(out, edge.ArrowHead, stroke, tip, direction);
+
+		if (edge.Label.size() > 0)
+		{
+			size_t middle = points.size() / 2;
+			Point center{ (points[middle - 1].X + points[middle].X) / 2, (points[middle - 1].Y + points[middle].Y) / 2 };
+
+			writeLines(out, edge.Label, center.X + 6, center.Y);
+		}
+
+		out << "</g>\n";
+	}
+
+	for (const Node& node : Nodes)
+	{
+		if (node.IsDummy)
+			continue;
+
+		out << "<g id=\"";
+
+		writeXmlText(out, node.Id);
+
+		out << "\" class=\"node\">\n";
+
+		if (node.Url.size() > 0)
+		{
+			out << "<a xlink:href=\"";
+
+			writeXmlText(out, node.Url);
+
+			out << "\">\n";
+		}
+
+		out << "<title>";
+
+		writeXmlText(out, node.Tooltip.size() > 0 ? std::string_view(node.Tooltip) : node.Id);
+
+		out << "</title>\n";
+
+		writeShape(out, node);
+		writeLines(out, node.Label, node.X, node.Y);
+
+		if (node.Url.size() > 0)
+			out << "</a>\n";
+
+		out << "</g>\n";
+	}
+
+	out << "</g>\n</svg>\n";
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "GraphText.h"
+
+// Layered (Sugiyama style) layout of the digraphs GraphData emits, written straight to SVG so no external dot pass is needed.
+struct GraphLayout
+{
+	struct Node
+	{
+		std::string_view Id;
+		std::vector<std::string> Label;
+		std::string Tooltip;
+		std::string_view Shape = "ellipse";
+		std::string_view Color;
+		std::string_view Url;
+		bool IsDummy = false;
+		int Rank = 0;
+		int Order = 0;
+		float X = 0;
+		float Y = 0;
+		float Width = 0;
+		float Height = 0;
+	};
+
+	struct Edge
+	{
+		int From = -1;
+		int To = -1;
+		std::vector<int> Chain;
+		std::vector<std::string> Label;
+		std::string_view Color;
+		std::string_view Style;
+		std::string_view ArrowHead = "normal";
+		bool Reversed = false;
+		bool Constraint = true;
+		bool Directed = true;
+	};
+
+	struct LayoutSettings
+	{
+		int CrossingSweeps = 8;
+		int CoordinateIterations = 8;
+		float RankSeparation = 56;
+		float NodeSeparation = 18;
+	};
+
+	LayoutSettings Settings;
+	std::string_view Name;
+	std::vector<Node> Nodes;
+	std::vector<Edge> Edges;
+	std::vector<std::vector<int>> Ranks;
+	float Width = 0;
+	float Height = 0;
+
+	void Build(const GraphText& graph);
+	void Layout();
+	void WriteSvg(std::ostream& out) const;
+
+private:
+	std::vector<std::vector<int>> UpperNeighbors;
+	std::vector<std::vector<int>> LowerNeighbors;
+
+	void AssignRanks();
+	void InsertDummyNodes();
+	void ReduceCrossings();
+	void AssignCoordinates();
+	long long CountCrossings() const;
+};
\ No newline at end of file
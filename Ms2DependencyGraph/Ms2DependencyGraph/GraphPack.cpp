@@ -0,0 +1,265 @@
+#include "GraphPack.h"
+
+#include <algorithm>
+#include <cstring>
+#include <tuple>
+#include <unordered_set>
+
+#include "Deflate.h"
+
+namespace
+{
+	auto sortKey(const GraphPackEntry& entry)
+	{
+		return std::make_tuple(entry.Kind, entry.Id, entry.Level, entry.Variant, entry.Part);
+	}
+
+	auto sortKey(const GraphPackKey& key)
+	{
+		return std::make_tuple(key.Kind, key.Id, key.Level, key.Variant, key.Part);
+	}
+}
+
+bool readGraphPackKey(const char* text, GraphPackKey& key, const std::vector<std::string>& variantNames)
+{
+	static const std::pair<std::string_view, GraphPackKind> kinds[] = {
+		{ "kit", GraphPackKind::ClassKit },
+		{ "set", GraphPackKind::SetBonus },
+		{ "skill", GraphPackKind::SkillDetail },
+		{ "effect", GraphPackKind::EffectDetail }
+	};
+
+	std::string_view keyText = text;
+	size_t separator = keyText.find(':');
+
+	if (separator == std::string_view::npos)
+		return false;
+
+	const auto kind = std::find_if(std::begin(kinds), std::end(kinds), [&keyText, separator](const auto& kind) { return kind.first == keyText.substr(0, separator); });
+
+	if (kind == std::end(kinds))
+		return false;
+
+	key = GraphPackKey{ kind->second };
+
+	const char* idText = text + separator + 1;
+	const char* levelText = strchr(idText, ':');
+	const char* variantText = strchr(idText, '@');
+
+	key.Id = atoi(idText);
+
+	if (levelText != nullptr)
+		key.Level = atoi(levelText + 1);
+
+	if (variantText == nullptr)
+		return true;
+
+	std::string_view variant = variantText + 1;
+
+	if (variant.size() > 0 && variant.find_first_not_of("0123456789") == std::string_view::npos)
+	{
+		key.Variant = (uint32_t)atoi(variant.data());
+
+		return true;
+	}
+
+	const auto name = std::find(variantNames.begin(), variantNames.end(), variant);
+
+	if (name == variantNames.end())
+		return false;
+
+	key.Variant = (uint32_t)(name - variantNames.begin() + 1);
+
+	return true;
+}
+
+bool GraphPackWriter::Open(const fs::path& packPath, const fs::path& outputRoot)
+{
+	if (packPath.has_parent_path())
+		fs::create_directories(packPath.parent_path());
+
+	OutFile.open(packPath, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+
+	if (!OutFile.is_open())
+		return false;
+
+	OutputRoot = outputRoot;
+	Entries.clear();
+	Paths.clear();
+	DataSize = 0;
+
+	GraphPackHeader header;
+
+	OutFile.write((const char*)&header, sizeof(header));
+
+	return OutFile.good();
+}
+
+bool GraphPackWriter::Append(const GraphPackKey& key, const fs::path& filePath, std::string_view data, GraphPackMethod method, uint64_t size)
+{
+	std::string path = filePath.lexically_relative(OutputRoot).generic_string();
+
+	GraphPackEntry entry;
+
+	entry.Kind = key.Kind;
+	entry.Id = key.Id;
+	entry.Level = key.Level;
+	entry.Part = key.Part;
+	entry.Variant = key.Variant;
+	entry.PathOffset = (uint32_t)Paths.size();
+	entry.PathLength = (uint32_t)path.size();
+	entry.Method = method;
+	entry.DataOffset = DataSize;
+	entry.StoredSize = data.size();
+	entry.Size = size;
+
+	Entries.push_back(entry);
+	Paths += path;
+	DataSize += data.size();
+
+	OutFile.write(data.data(), data.size());
+
+	return OutFile.good();
+}
+
+bool GraphPackWriter::Close()
+{
+	if (!OutFile.is_open())
+		return false;
+
+	std::stable_sort(Entries.begin(), Entries.end(), [](const GraphPackEntry& left, const GraphPackEntry& right) { return sortKey(left) < sortKey(right); });
+
+	// the index starts 8 byte aligned so the mapped entries can be read in place
+	uint64_t padding = (8 - (sizeof(GraphPackHeader) + DataSize) % 8) % 8;
+
+	OutFile.write("\0\0\0\0\0\0\0", padding);
+
+	GraphPackHeader header;
+
+	header.EntryCount = (uint32_t)Entries.size();
+	header.PathsSize = (uint32_t)Paths.size();
+	header.IndexOffset = sizeof(GraphPackHeader) + DataSize + padding;
+
+	OutFile.write((const char*)Entries.data(), Entries.size() * sizeof(GraphPackEntry));
+	OutFile.write(Paths.data(), Paths.size());
+	OutFile.seekp(0);
+	OutFile.write((const char*)&header, sizeof(header));
+	OutFile.close();
+
+	return !OutFile.fail();
+}
+
+bool GraphPack::Open(const fs::path& packPath)
+{
+	Entries = nullptr;
+	EntryCount = 0;
+
+	if (!File.Open(packPath))
+		return false;
+
+	std::string_view data = File.GetText();
+	GraphPackHeader header;
+
+	if (data.size() < sizeof(header))
+		return false;
+
+	memcpy(&header, data.data(), sizeof(header));
+
+	if (memcmp(header.Magic, GraphPackHeader().Magic, 4) != 0 || header.Version != 1 || header.IndexOffset < sizeof(header))
+		return false;
+
+	size_t tableSize = (size_t)header.EntryCount * sizeof(GraphPackEntry);
+
+	if (data.size() < header.IndexOffset + tableSize + header.PathsSize)
+		return false;
+
+	Entries = (const GraphPackEntry*)(data.data() + header.IndexOffset);
+	EntryCount = header.EntryCount;
+	Paths = data.substr(header.IndexOffset + tableSize, header.PathsSize);
+	Data = data.substr(sizeof(header), header.IndexOffset - sizeof(header));
+
+	return true;
+}
+
+const GraphPackEntry* GraphPack::Find(const GraphPackKey& key) const
+{
+	const GraphPackEntry* end = Entries + EntryCount;
+	const GraphPackEntry* entry = std::lower_bound(Entries, end, key, [](const GraphPackEntry& entry, const GraphPackKey& key) { return sortKey(entry) < sortKey(key); });
+
+	if (entry == end || sortKey(*entry) != sortKey(key))
+		return nullptr;
+
+	return entry;
+}
+
+std::string_view GraphPack::GetPath(const GraphPackEntry& entry) const
+{
+	if ((size_t)entry.PathOffset + entry.PathLength > Paths.size())
+		return std::string_view();
+
+	return Paths.substr(entry.PathOffset, entry.PathLength);
+}
+
+std::string_view GraphPack::GetStoredData(const GraphPackEntry& entry) const
+{
+	if (entry.DataOffset + entry.StoredSize > Data.size())
+		return std::string_view();
+
+	return Data.substr(entry.DataOffset, entry.StoredSize);
+}
+
+bool GraphPack::Read(const GraphPackEntry& entry, std::string& text) const
+{
+	if (entry.DataOffset + entry.StoredSize > Data.size())
+		return false;
+
+	std::string_view data = Data.substr(entry.DataOffset, entry.StoredSize);
+
+	if (entry.Method == GraphPackMethod::Stored)
+	{
+		text.assign(data);
+
+		return true;
+	}
+
+	if (entry.Method == GraphPackMethod::Gzip)
+		return gunzipData(data, text) && text.size() == entry.Size;
+
+	return false;
+}
+
+void GraphPack::ForEach(const std::function<void(const GraphPackEntry&)>& callback) const
+{
+	for (uint32_t i = 0; i < EntryCount; ++i)
+		callback(Entries[i]);
+}
+
+bool GraphPack::Extract(const fs::path& outputRoot) const
+{
+	std::unordered_set<std::string> createdDirectories;
+	bool succeeded = true;
+
+	ForEach([this, &outputRoot, &createdDirectories, &succeeded](const GraphPackEntry& entry)
+	{
+		fs::path filePath = outputRoot / GetPath(entry);
+		fs::path directory = filePath.parent_path();
+
+		if (createdDirectories.insert(directory.string()).second)
+			fs::create_directories(directory);
+
+		if ((entry.Method != GraphPackMethod::Stored && entry.Method != GraphPackMethod::Gzip) || entry.DataOffset + entry.StoredSize > Data.size())
+		{
+			succeeded = false;
+
+			return;
+		}
+
+		std::ofstream outFile(filePath, entry.Method == GraphPackMethod::Stored ? std::ofstream::out : std::ofstream::out | std::ofstream::binary);
+
+		outFile << GetStoredData(entry);
+
+		succeeded &= outFile.good();
+	});
+
+	return succeeded;
+}
\ No newline at end of file
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "MappedFile.h"
+
+namespace fs = std::filesystem;
+
+enum class GraphPackKind : uint32_t
+{
+	ClassKit = 0,
+	SetBonus = 1,
+	SkillDetail = 2,
+	EffectDetail = 3
+};
+
+// Which graph a document belongs to. Part is 0 for the graph itself, or the index of a split graph, and n for its
+// part_n files. Variant is 0 for the graph printed with the main print settings, and n for the nth --variant.
+struct GraphPackKey
+{
+	GraphPackKind Kind = GraphPackKind::ClassKit;
+	int Id = 0;
+	int Level = -1;
+	uint32_t Part = 0;
+	uint32_t Variant = 0;
+};
+
+// "kit:<job>", "set:<id>", "skill:<id>[:<level>]" or "effect:<id>[:<level>]", followed by "@<variant>" for a variant.
+// The variant is its number or one of variantNames, the --variant names in order, which are numbered from 1
+bool readGraphPackKey(const char* text, GraphPackKey& key, const std::vector<std::string>& variantNames = {});
+
+// Every generated graph in one file instead of a file each.
+// Layout: GraphPackHeader, the documents appended as they were written, then at IndexOffset EntryCount GraphPackEntry
+// records sorted by key followed by the paths. Paths are relative to the output root with '/' separators, so a pack can
+// be extracted into the tree the loose files would have made.
+struct GraphPackHeader
+{
+	char Magic[4] = { 'M', 'G', 'P', 'K' };
+	uint32_t Version = 1;
+	uint32_t EntryCount = 0;
+	uint32_t PathsSize = 0;
+	uint64_t IndexOffset = 0;
+};
+
+enum class GraphPackMethod : uint32_t
+{
+	Stored = 0,
+
+	// one gzip member, the bytes the loose .gz file would hold
+	Gzip = 1
+};
+
+struct GraphPackEntry
+{
+	GraphPackKind Kind = GraphPackKind::ClassKit;
+	int32_t Id = 0;
+	int32_t Level = -1;
+	uint32_t Part = 0;
+	uint32_t PathOffset = 0;
+	uint32_t PathLength = 0;
+	GraphPackMethod Method = GraphPackMethod::Stored;
+	uint32_t Variant = 0;
+	uint64_t DataOffset = 0;
+	uint64_t StoredSize = 0;
+	uint64_t Size = 0;
+};
+
+// Appends documents to a pack; the index is only written by Close, so a pack cut short by a crash won't open.
+class GraphPackWriter
+{
+public:
+	bool Open(const fs::path& packPath, const fs::path& outputRoot);
+	bool IsOpen() const { return OutFile.is_open(); }
+
+	// size is the length of the document once data is decompressed
+	bool Append(const GraphPackKey& key, const fs::path& filePath, std::string_view data, GraphPackMethod method, uint64_t size);
+	bool Close();
+
+private:
+	std::ofstream OutFile;
+	fs::path OutputRoot;
+	std::vector<GraphPackEntry> Entries;
+	std::string Paths;
+	uint64_t DataSize = 0;
+};
+
+class GraphPack
+{
+public:
+	bool Open(const fs::path& packPath);
+	bool IsOpen() const { return Entries != nullptr; }
+
+	// A graph written under more than one output root has an entry for each; the first is returned.
+	const GraphPackEntry* Find(const GraphPackKey& key) const;
+	std::string_view GetPath(const GraphPackEntry& entry) const;
+	std::string_view GetStoredData(const GraphPackEntry& entry) const;
+
+	// the document text, decompressed if it was stored compressed
+	bool Read(const GraphPackEntry& entry, std::string& text) const;
+
+	void ForEach(const std::function<void(const GraphPackEntry&)>& callback) const;
+
+	// Writes every document to its path under outputRoot. Compressed documents are written as stored, like the loose
+	// .gz files would have been.
+	bool Extract(const fs::path& outputRoot) const;
+
+private:
+	MappedFile File;
+	const GraphPackEntry* Entries = nullptr;
+	uint32_t EntryCount = 0;
+	std::string_view Paths;
+	std::string_view Data;
+};
\ No newline at end of file
@@ -0,0 +1,320 @@
+#include "GraphPartitioning.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace
+{
+	struct PartitionState
+	{
+		int MaxPartNodes = 0;
+		std::vector<std::vector<int>> Adjacency;
+		std::vector<int> LocalIndex;
+		std::vector<std::vector<int>> Pieces;
+
+		void Split(std::vector<int>& nodes);
+		int FindBestCutVertex(const std::vector<int>& nodes);
+		void CollectGroups(const std::vector<int>& nodes, int excludedNode, std::vector<std::vector<int>>& groups);
+	};
+
+	void PartitionState::CollectGroups(const std::vector<int>& nodes, int excludedNode, std::vector<std::vector<int>>& groups)
+	{
+		std::vector<int> queue;
+
+		for (int node : nodes)
+			LocalIndex[node] = 0;
+
+		if (excludedNode != -1)
+			LocalIndex[excludedNode] = -1;
+
+		for (int start : nodes)
+		{
+			if (LocalIndex[start] != 0)
+				continue;
+
+			groups.push_back(std::vector<int>());
+
+			std::vector<int>& group = groups.back();
+
+			queue.clear();
+			queue.push_back(start);
+			LocalIndex[start] = 1;
+
+			for (size_t i = 0; i < queue.size(); ++i)
+			{
+				int node = queue[i];
+
+				group.push_back(node);
+
+				for (int neighbor : Adjacency[node])
+				{
+					if (LocalIndex[neighbor] != 0)
+						continue;
+
+					LocalIndex[neighbor] = 1;
+					queue.push_back(neighbor);
+				}
+			}
+		}
+
+		for (int node : nodes)
+			LocalIndex[node] = -1;
+	}
+
+	int PartitionState::FindBestCutVertex(const std::vector<int>& nodes)
+	{
+		int count = (int)nodes.size();
+
+		for (int i = 0; i < count; ++i)
+			LocalIndex[nodes[i]] = i;
+
+		std::vector<int> discovered(count, -1);
+		std::vector<int> low(count, 0);
+		std::vector<int> subtreeSize(count, 1);
+		std::vector<int> parent(count, -1);
+		std::vector<int> separatedSize(count, 0);
+		std::vector<int> largestPiece(count, 0);
+		std::vector<int> rootChildren(count, 0);
+		std::vector<std::pair<int, size_t>> stack;
+
+		int time = 0;
+
+		discovered[0] = low[0] = time++;
+		stack.push_back({ 0, 0 });
+
+		while (stack.size() > 0)
+		{
+			auto& [local, nextNeighbor] = stack.back();
+
+			const std::vector<int>& neighbors = Adjacency[nodes[local]];
+
+			if (nextNeighbor < neighbors.size())
+			{
+				int neighbor = LocalIndex[neighbors[nextNeighbor++]];
+
+				if (neighbor == -1)
+					continue;
+
+				if (discovered[neighbor] == -1)
+				{
+					parent[neighbor] = local;
+					discovered[neighbor] = low[neighbor] = time++;
+					stack.push_back({ neighbor, 0 });
+				}
+				else if (neighbor != parent[local])
+					low[local] = std::min(low[local], discovered[neighbor]);
+
+				continue;
+			}
+
+			int finished = local;
+
+			stack.pop_back();
+
+			int parentLocal = parent[finished];
+
+			if (parentLocal == -1)
+				continue;
+
+			subtreeSize[parentLocal] += subtreeSize[finished];
+			low[parentLocal] = std::min(low[parentLocal], low[finished]);
+
+			if (parentLocal == 0)
+				++rootChildren[0];
+
+			if (low[finished] >= discovered[parentLocal])
+			{
+				separatedSize[parentLocal] += subtreeSize[finished];
+				largestPiece[parentLocal] = std::max(largestPiece[parentLocal], subtreeSize[finished]);
+			}
+		}
+
+		int bestNode = -1;
+		int bestPiece = count;
+
+		for (int i = 0; i < count; ++i)
+		{
+			if (separatedSize[i] == 0 || (i == 0 && rootChildren[0] < 2))
+				continue;
+
+			int piece = std::max(largestPiece[i], count - 1 - separatedSize[i]);
+
+			if (piece < bestPiece)
+			{
+				bestPiece = piece;
+				bestNode = nodes[i];
+			}
+		}
+
+		for (int node : nodes)
+			LocalIndex[node] = -1;
+
+		return bestNode;
+	}
+
+	void PartitionState::Split(std::vector<int>& nodes)
+	{
+		if (MaxPartNodes <= 0 || (int)nodes.size() <= MaxPartNodes)
+		{
+			Pieces.push_back(std::move(nodes));
+
+			return;
+		}
+
+		int cutVertex = FindBestCutVertex(nodes);
+
+		if (cutVertex == -1)
+		{
+			Pieces.push_back(std::move(nodes));
+
+			return;
+		}
+
+		std::vector<std::vector<int>> groups;
+
+		CollectGroups(nodes, cutVertex, groups);
+
+		for (std::vector<int>& group : groups)
+		{
+			group.push_back(cutVertex);
+
+			Split(group);
+		}
+	}
+}
+
+void GraphPartitioning::Partition(const GraphText& graph, std::string_view rootName, int maxPartNodes)
+{
+	Nodes.clear();
+	Parts.clear();
+	RootStatements.clear();
+
+	std::unordered_map<std::string_view, int> nodeIndices;
+
+	const auto getNode = [this, &nodeIndices](std::string_view name)
+	{
+		auto [index, inserted] = nodeIndices.try_emplace(name, (int)Nodes.size());
+
+		if (inserted)
+			Nodes.push_back(name);
+
+		return index->second;
+	};
+
+	RootNode = getNode(rootName);
+
+	std::vector<std::pair<int, int>> statementNodes(graph.Statements.size());
+
+	for (size_t i = 0; i < graph.Statements.size(); ++i)
+	{
+		const GraphStatement& statement = graph.Statements[i];
+
+		statementNodes[i].first = getNode(statement.From);
+		statementNodes[i].second = statement.IsEdge() ? getNode(statement.To) : -1;
+	}
+
+	PartitionState state;
+
+	state.MaxPartNodes = maxPartNodes;
+	state.Adjacency.resize(Nodes.size());
+	state.LocalIndex.resize(Nodes.size(), -1);
+
+	for (const auto& [from, to] : statementNodes)
+	{
+		if (to == -1 || from == to || from == RootNode || to == RootNode)
+			continue;
+
+		state.Adjacency[from].push_back(to);
+		state.Adjacency[to].push_back(from);
+	}
+
+	std::vector<int> nonRootNodes;
+
+	for (int i = 0; i < (int)Nodes.size(); ++i)
+		if (i != RootNode)
+			nonRootNodes.push_back(i);
+
+	std::vector<std::vector<int>> components;
+
+	state.CollectGroups(nonRootNodes, -1, components);
+
+	for (std::vector<int>& component : components)
+		state.Split(component);
+
+	std::vector<std::vector<int>> nodeParts(Nodes.size());
+
+	for (std::vector<int>& piece : state.Pieces)
+	{
+		int partIndex = -1;
+
+		if (maxPartNodes > 0)
+		{
+			for (int i = 0; i < (int)Parts.size() && partIndex == -1; ++i)
+				if (Parts[i].Nodes.size() + piece.size() <= (size_t)maxPartNodes)
+					partIndex = i;
+		}
+
+		if (partIndex == -1)
+		{
+			partIndex = (int)Parts.size();
+			Parts.push_back(GraphPart{});
+		}
+
+		GraphPart& part = Parts[partIndex];
+
+		for (int node : piece)
+		{
+			std::vector<int>& parts = nodeParts[node];
+
+			if (std::find(parts.begin(), parts.end(), partIndex) != parts.end())
+				continue;
+
+			parts.push_back(partIndex);
+			part.Nodes.push_back(node);
+		}
+	}
+
+	for (int i = 0; i < (int)statementNodes.size(); ++i)
+	{
+		auto [from, to] = statementNodes[i];
+
+		if (to == -1)
+		{
+			if (from == RootNode)
+				RootStatements.push_back(i);
+			else
+				for (int partIndex : nodeParts[from])
+					Parts[partIndex].Statements.push_back(i);
+
+			continue;
+		}
+
+		if (from == RootNode && to == RootNode)
+		{
+			RootStatements.push_back(i);
+
+			continue;
+		}
+
+		if (from == RootNode || to == RootNode)
+		{
+			Parts[nodeParts[from == RootNode ? to : from].front()].Statements.push_back(i);
+
+			continue;
+		}
+
+		int partIndex = nodeParts[from].front();
+
+		for (int candidate : nodeParts[from])
+		{
+			if (std::find(nodeParts[to].begin(), nodeParts[to].end(), candidate) == nodeParts[to].end())
+				continue;
+
+			partIndex = candidate;
+
+			break;
+		}
+
+		Parts[partIndex].Statements.push_back(i);
+	}
+}
\ No newline at end of file
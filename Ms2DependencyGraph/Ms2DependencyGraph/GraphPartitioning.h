@@ -0,0 +1,27 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+#include "GraphText.h"
+
+struct GraphPart
+{
+	std::vector<int> Nodes;
+	std::vector<int> Statements;
+};
+
+struct GraphPartitioning
+{
+	std::vector<std::string_view> Nodes;
+	std::vector<GraphPart> Parts;
+
+	// Statements touching only the root node, kept out of the parts so each writer can decide where they belong.
+	std::vector<int> RootStatements;
+
+	int RootNode = -1;
+
+	// Splits the graph into the weakly connected components left after removing the root. With maxPartNodes set,
+	// oversized components are cut at articulation points and small components are packed together up to the limit.
+	void Partition(const GraphText& graph, std::string_view rootName, int maxPartNodes = 0);
+};
\ No newline at end of file
@@ -1,10 +1,149 @@
 #include "GraphPrinting.h"
 
 #include <iostream>
+#include <iterator>
+#include <string>
 
 #include "XmlParsing.h"
+#include "GraphWriting.h"
 
-const ReferenceData& GraphData::Dereference(const ReferenceData& reference, bool isSplash)
+GraphTraversalLimits traversalLimits;
+GraphPrintSettings printSettings;
+
+namespace
+{
+	const std::pair<std::string_view, PrintFlag> printFlagNames[] = {
+		{ "types", PrintFlag::Types },
+		{ "effect-types", PrintFlag::EffectTypes },
+		{ "paths", PrintFlag::Paths },
+		{ "reset", PrintFlag::Reset },
+		{ "keep-condition", PrintFlag::KeepCondition },
+		{ "stacks", PrintFlag::Stacks },
+		{ "motions", PrintFlag::Motions },
+		{ "attacks", PrintFlag::Attacks },
+		{ "targets", PrintFlag::Targets },
+		{ "immediate-active", PrintFlag::ImmediateActiveSkill },
+		{ "target", PrintFlag::Target },
+		{ "require-skill-codes", PrintFlag::RequireSkillCodeConnections },
+		{ "attack-material", PrintFlag::AttackMaterial },
+		{ "non-target-attack", PrintFlag::NonTargetAttack },
+		{ "apply-target", PrintFlag::ApplyTarget }
+	};
+
+	const std::pair<std::string_view, uint32_t> printPresetNames[] = {
+		{ "default", defaultPrintFlags },
+		{ "compact", compactPrintFlags },
+		{ "detailed", detailedPrintFlags }
+	};
+
+	// Printing only reads the model, so queries can share one. Ids and levels that were never loaded read as empty
+	// entries, the same as the ones operator[] used to add for them.
+	template <typename Value>
+	const Value& findModelEntry(const std::unordered_map<int, Value>& entries, int id)
+	{
+		static const Value empty;
+
+		auto index = entries.find(id);
+
+		return index == entries.end() ? empty : index->second;
+	}
+
+	template <typename Level>
+	const Level& findLevel(const std::unordered_map<int, Level>& levels, int level)
+	{
+		return level == -1 ? levels.begin()->second : findModelEntry(levels, level);
+	}
+
+	bool readPrintSetting(std::string_view token, GraphPrintSettings& settings)
+	{
+		for (const auto& preset : printPresetNames)
+		{
+			if (token != preset.first)
+				continue;
+
+			settings.Flags = preset.second;
+
+			return true;
+		}
+
+		bool enabled = true;
+
+		if (token[0] == '+' || token[0] == '-')
+		{
+			enabled = token[0] == '+';
+			token = token.substr(1);
+		}
+
+		size_t equals = token.find('=');
+
+		if (equals != std::string_view::npos)
+		{
+			std::string_view value = token.substr(equals + 1);
+
+			enabled = value == "1" || value == "true" || value == "on";
+			token = token.substr(0, equals);
+		}
+
+		for (const auto& flag : printFlagNames)
+		{
+			if (token != flag.first)
+				continue;
+
+			settings.Set(flag.second, enabled);
+
+			return true;
+		}
+
+		std::cout << "unknown print setting: " << token << std::endl;
+
+		return false;
+	}
+}
+
+bool readPrintSettings(std::string_view text, GraphPrintSettings& settings)
+{
+	bool succeeded = true;
+	bool inComment = false;
+	size_t tokenStart = std::string_view::npos;
+
+	for (size_t i = 0; i <= text.size(); ++i)
+	{
+		char character = i < text.size() ? text[i] : '\n';
+
+		if (character == '\n' || character == '\r')
+			inComment = false;
+		else if (character == '#')
+			inComment = true;
+
+		bool separator = inComment || character == ',' || character == ' ' || character == '\t' || character == '\n' || character == '\r' || character == '#';
+
+		if (!separator && tokenStart == std::string_view::npos)
+			tokenStart = i;
+
+		if (separator && tokenStart != std::string_view::npos)
+		{
+			succeeded &= readPrintSetting(text.substr(tokenStart, i - tokenStart), settings);
+
+			tokenStart = std::string_view::npos;
+		}
+	}
+
+	return succeeded;
+}
+
+bool loadPrintSettings(const fs::path& filePath, GraphPrintSettings& settings)
+{
+	std::ifstream file(filePath, std::ifstream::in | std::ifstream::binary);
+
+	if (!file.is_open())
+		return false;
+
+	std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	return readPrintSettings(text, settings);
+}
+
+const ReferenceData& GraphData::Dereference(const ReferenceData& reference)
 {
 	int id = reference.Id;
 
@@ -12,10 +151,7 @@ const ReferenceData& GraphData::Dereference(const ReferenceData& reference, bool
 
 	if (reference.Type == ReferenceType::Skill)
 	{
-		if (isSplash && !ReferencedSplashSkills.contains(id))
-			ReferencedSplashSkills.insert(id);
-
-		if (skills[id].ScalingLevels)
+		if (findModelEntry(model().Skills, id).ScalingLevels)
 			data.Level = -1;
 
 		References& refs = ReferencedSkills[id];
@@ -26,12 +162,13 @@ const ReferenceData& GraphData::Dereference(const ReferenceData& reference, bool
 			return refs.Reference;
 
 		QueuedSkills.push_back(data);
+		QueuedSkillDepths.push_back(CurrentDepth + 1);
 		refs.LevelReferences[data.Level] = std::vector<ReferenceData>();
 
 		return QueuedSkills.back();
 	}
 
-	if (effects[id].ScalingLevels)
+	if (findModelEntry(model().Effects, id).ScalingLevels)
 		data.Level = -1;
 
 	References& refs = ReferencedEffects[id];
@@ -41,21 +178,274 @@ const ReferenceData& GraphData::Dereference(const ReferenceData& reference, bool
 		return refs.Reference;
 
 	QueuedEffects.push_back(data);
+	QueuedEffectDepths.push_back(CurrentDepth + 1);
 	refs.LevelReferences[data.Level] = std::vector<ReferenceData>();
 
 	return QueuedEffects.back();
 }
 
+bool GraphData::Admit(const ReferenceData& reference)
+{
+	if (!Limits.IsLimited())
+		return true;
+
+	bool isSkill = reference.Type == ReferenceType::Skill;
+	int level = reference.Level;
+
+	if (isSkill)
+	{
+		auto skillIndex = model().Skills.find(reference.Id);
+
+		if (skillIndex == model().Skills.end() || skillIndex->second.ScalingLevels)
+			level = -1;
+	}
+	else
+	{
+		auto effectIndex = model().Effects.find(reference.Id);
+
+		if (effectIndex == model().Effects.end() || effectIndex->second.ScalingLevels)
+			level = -1;
+	}
+
+	std::unordered_map<int, References>& referenced = isSkill ? ReferencedSkills : ReferencedEffects;
+
+	auto referenceIndex = referenced.find(reference.Id);
+
+	if (referenceIndex != referenced.end() && referenceIndex->second.LevelReferences.contains(level))
+		return true;
+
+	bool withinDepth = Limits.MaxDepth <= 0 || CurrentDepth < Limits.MaxDepth;
+	bool withinNodes = Limits.MaxNodes <= 0 || (int)(QueuedSkills.size() + QueuedEffects.size()) < Limits.MaxNodes;
+	bool withinFanOut = Limits.MaxFanOut <= 0 || CurrentFanOut < Limits.MaxFanOut;
+
+	if (withinDepth && withinNodes && withinFanOut)
+	{
+		++CurrentFanOut;
+
+		return true;
+	}
+
+	if (isSkill)
+		CollapsedSkills.insert(reference.Id);
+	else
+		CollapsedEffects.insert(reference.Id);
+
+	return false;
+}
+
+void GraphData::BeginLinked(const ReferenceData& reference, int depth)
+{
+	CurrentReference = reference;
+	CurrentDepth = depth;
+	CurrentFanOut = 0;
+	CollapsedSkills.clear();
+	CollapsedEffects.clear();
+}
+
+void GraphData::EndLinked()
+{
+	GraphOutput& out = Output();
+
+	if (CollapsedSkills.size() == 0 && CollapsedEffects.size() == 0)
+		return;
+
+	out << "\t" << CurrentReference << " -> collapsed_" << CurrentReference << " [style=dashed]\n";
+	out << "\tcollapsed_" << CurrentReference << " [label=\"+";
+
+	if (CollapsedEffects.size() > 0)
+		out << CollapsedEffects.size() << (CollapsedEffects.size() == 1 ? " effect" : " effects");
+
+	if (CollapsedEffects.size() > 0 && CollapsedSkills.size() > 0)
+		out << ", ";
+
+	if (CollapsedSkills.size() > 0)
+		out << CollapsedSkills.size() << (CollapsedSkills.size() == 1 ? " skill" : " skills");
+
+	out << "\" shape=note URL=\"" << DetailUrlPrefix << CurrentReference << ".svg\"]\n";
+
+	CollapsedNodes.push_back(CurrentReference);
+}
+
+namespace
+{
+	template <typename Flags>
+	void writeEventEdge(uint32_t flagBits, std::ostream& out, const ConditionSkill& trigger)
+	{
+		Flags flags(flagBits);
+
+		if (flags(PrintFlag::Target) && trigger.SkillTarget != SkillTarget::SkillTarget)
+		{
+			out << " [label=\"" << SkillTargetNames[(int)trigger.SkillTarget] << "\"]";
+		}
+	}
+
+	template <typename Flags>
+	void writeCastEdge(uint32_t flagBits, std::ostream& out, const ConditionSkill& trigger, bool afterEvent)
+	{
+		Flags flags(flagBits);
+
+		if (!afterEvent && flags(PrintFlag::Target) && trigger.SkillTarget != SkillTarget::SkillTarget)
+			out << " label=\"" << SkillTargetNames[(int)trigger.SkillTarget] << "\"";
+	}
+
+	template <typename Flags>
+	void writeTriggerEdge(uint32_t flagBits, std::ostream& out, const ConditionSkill& trigger, const std::string& style, bool afterEvent, const SkillAttack* attack)
+	{
+		Flags flags(flagBits);
+
+		bool printTarget = !afterEvent && flags(PrintFlag::Target) && trigger.SkillTarget != SkillTarget::SkillTarget;
+		bool printAttackMaterial = attack != nullptr && flags(PrintFlag::AttackMaterial);
+		bool printNonTargetAttack = attack != nullptr && flags(PrintFlag::NonTargetAttack) && trigger.IsSplash;
+		bool printApplyTarget = attack != nullptr && flags(PrintFlag::ApplyTarget);
+
+		if (style != "" || printTarget || printAttackMaterial || printNonTargetAttack || printApplyTarget)
+			out << " [" << style; 
+
+		if (printTarget || printAttackMaterial || printNonTargetAttack || printApplyTarget)
+		{
+			out << " label=\"";
+
+			if (printTarget)
+				out << SkillTargetNames[(int)trigger.SkillTarget] << (printAttackMaterial || printNonTargetAttack || printApplyTarget ? "\\n" : "");
+
+			if (printAttackMaterial)
+				out << "AttackMaterial: " << (int)attack->AttackMaterial << (printNonTargetAttack || printApplyTarget ? "\\n" : "");
+
+			if (printApplyTarget)
+				out << "ApplyTarget: " << ApplyTargetNames[(int)attack->ApplyTarget] << "\\nCastTarget: " << ApplyTargetNames[(int)attack->CastTarget] << (printNonTargetAttack ? "\\n" : "");
+
+			bool targetingNone = printNonTargetAttack && (((trigger.NonTargetActive || attack->CubeMagicPathId > 0) && attack->MagicPathId == 0) || attack->ApplyTarget == ApplyTarget::None);
+
+			if (printNonTargetAttack)
+				out << "No Target: " << targetingNone;
+
+			out << "\" ";
+		}
+
+		if (style != "" || printTarget || printAttackMaterial || printNonTargetAttack || printApplyTarget)
+			out << "]";
+	}
+
+	template <typename Flags>
+	void writeSkillNode(uint32_t flagBits, std::ostream& out, const SkillData& skill, const SkillLevelData* skillLevel)
+	{
+		Flags flags(flagBits);
+
+		if (flags(PrintFlag::Types))
+			out << "\\nType: " << skill.Type << "\\nSubType: " << skill.SubType;
+
+		if (flags(PrintFlag::ImmediateActiveSkill))
+			out << "\\nImmediateActive: " << skill.ImmediateActive;
+
+		if (skillLevel != nullptr)
+		{
+			if (skillLevel->TotalMotionsWithPaths > 0 && flags(PrintFlag::Paths))
+			{
+				out << "\\nHas Path";
+			}
+			if (skillLevel->TotalMotionsWithCubePaths > 0 && flags(PrintFlag::Paths))
+			{
+				out << "\\nHas Cube Path";
+			}
+
+			if (skillLevel->Motions.size() > 1 && flags(PrintFlag::Motions))
+				out << "\\n" << skillLevel->Motions.size() << " Motions";
+
+			if (skillLevel->TotalAttacks > 1 && flags(PrintFlag::Attacks))
+				out << "\\n" << skillLevel->TotalAttacks << " Attacks";
+		}
+	}
+
+	template <typename Flags>
+	void writeEffectNode(uint32_t flagBits, std::ostream& out, const AdditionalEffectLevelData& effectLevel)
+	{
+		Flags flags(flagBits);
+
+		if (flags(PrintFlag::EffectTypes))
+			out << "\\nType: " << effectLevel.Type << "\\nSubType: " << effectLevel.SubType;
+
+		if (flags(PrintFlag::Reset))
+			out << "\\nResetCondition: " << effectLevel.ResetCondition;
+
+		if (flags(PrintFlag::Stacks))
+			out << "\\nMax Stacks: " << effectLevel.MaxStacks;
+
+		if (flags(PrintFlag::KeepCondition))
+			out << "\\nKeepCondition: " << effectLevel.KeepCondition;
+	}
+
+	template <typename Flags>
+	const GraphLabelWriter labelWriter = {
+		writeEventEdge<Flags>,
+		writeCastEdge<Flags>,
+		writeTriggerEdge<Flags>,
+		writeSkillNode<Flags>,
+		writeEffectNode<Flags>
+	};
+}
+
+const GraphLabelWriter& getLabelWriter(uint32_t flags)
+{
+	switch (flags)
+	{
+	case defaultPrintFlags:
+		return labelWriter<StaticPrintFlags<defaultPrintFlags>>;
+
+	case compactPrintFlags:
+		return labelWriter<StaticPrintFlags<compactPrintFlags>>;
+
+	case detailedPrintFlags:
+		return labelWriter<StaticPrintFlags<detailedPrintFlags>>;
+
+	default:
+		return labelWriter<RuntimePrintFlags>;
+	}
+}
+
+GraphOutput& GraphData::Output()
+{
+	if (Out.Variants.size() == 0)
+		Out.Variants.push_back(GraphVariant{ &OutFile, Settings, &getLabelWriter(Settings.Flags) });
+
+	return Out;
+}
+
+void GraphData::AddVariant(std::ostream& outFile, const GraphPrintSettings& settings)
+{
+	Output().Variants.push_back(GraphVariant{ &outFile, settings, &getLabelWriter(settings.Flags) });
+}
+
 void GraphData::Print(const ReferenceData& caller, const ConditionSkill& trigger, const std::string& style, int index1, int index2, const SkillAttack* attack)
 {
+	GraphOutput& out = Output();
+
 	std::vector<ReferenceData>& references = caller.Type == ReferenceType::Skill ? ReferencedSkills[caller.Id].LevelReferences[caller.Level] : ReferencedEffects[caller.Id].LevelReferences[caller.Level];
 
+	std::vector<bool> admittedCasts;
+
+	if (trigger.RandomCasts.size() > 0)
+	{
+		bool anyAdmitted = false;
+
+		for (const ReferenceData& cast : trigger.RandomCasts)
+		{
+			admittedCasts.push_back(Admit(cast));
+
+			anyAdmitted |= admittedCasts.back();
+		}
+
+		if (!anyAdmitted)
+			return;
+	}
+	else if (!Admit(trigger.Reference))
+		return;
+
 	std::stringstream outRefStream;
 
 	outRefStream << caller;
 
 	std::string outRef;
-	bool printTarget = Settings.PrintTarget && trigger.SkillTarget != SkillTarget::SkillTarget;
+	bool afterEvent = false;
 
 	if (index1 != -1 && trigger.Condition.EventCondition != EventCondition::None)
 	{
@@ -66,18 +456,16 @@ void GraphData::Print(const ReferenceData& caller, const ConditionSkill& trigger
 
 		outRef = outRefStream.str();
 
-		OutFile << "\t" << caller << " -> " << outRef;
+		out << "\t" << caller << " -> " << outRef;
 
-		if (printTarget)
-		{
-			OutFile << " [label=\"" << SkillTargetNames[(int)trigger.SkillTarget] << "\"]";
-		}
+		for (GraphVariant& variant : out.Variants)
+			variant.Labels->EventEdge(variant.Settings.Flags, *variant.OutFile, trigger);
 
-		printTarget = false;
+		afterEvent = true;
 
-		OutFile << "\n";
+		out << "\n";
 
-		OutFile << "\t" << outRef << " [label=\"" << SkillTargetNames[(int)trigger.Condition.EventTarget] << "\\n" << EventConditionNames[(int)trigger.Condition.EventCondition] << "\" shape=component]\n";
+		out << "\t" << outRef << " [label=\"" << SkillTargetNames[(int)trigger.Condition.EventTarget] << "\\n" << EventConditionNames[(int)trigger.Condition.EventCondition] << "\" shape=component]\n";
 	}
 	else
 		outRef = outRefStream.str();
@@ -88,6 +476,9 @@ void GraphData::Print(const ReferenceData& caller, const ConditionSkill& trigger
 		{
 			const ReferenceData& cast = trigger.RandomCasts[i];
 
+			if (!admittedCasts[i])
+				continue;
+
 			bool linkReferenced = false;
 
 			for (int i = 0; i < references.size() && !linkReferenced; ++i)
@@ -96,12 +487,12 @@ void GraphData::Print(const ReferenceData& caller, const ConditionSkill& trigger
 
 			references.push_back(cast);
 
-			OutFile << "\t" << outRef << " -> " << Dereference(cast, trigger.IsSplash) << " [color=\"orange\"";
-			
-			if (printTarget)
-				OutFile << " label=\"" << SkillTargetNames[(int)trigger.SkillTarget] << "\"";
-			
-			OutFile << "]\n";
+			out << "\t" << outRef << " -> " << Dereference(cast) << " [color=\"orange\"";
+
+			for (GraphVariant& variant : out.Variants)
+				variant.Labels->CastEdge(variant.Settings.Flags, *variant.OutFile, trigger, afterEvent);
+
+			out << "]\n";
 		}
 
 		return;
@@ -113,60 +504,30 @@ void GraphData::Print(const ReferenceData& caller, const ConditionSkill& trigger
 
 	references.push_back(trigger.Reference);
 
-	OutFile << "\t" << outRef << " -> " << Dereference(trigger.Reference, trigger.IsSplash);
-	
-	//if (printTarget)
-	//	OutFile << " label=\"" << SkillTargetNames[(int)trigger.SkillTarget] << "\"";
-
-	bool printAttackMaterial = attack != nullptr && Settings.PrintAttackMaterial;
-	bool printNonTargetAttack = attack != nullptr && Settings.PrintNonTargetAttack && trigger.IsSplash;
-	bool printApplyTarget = attack != nullptr && Settings.PrintApplyTarget;
-
-	if (style != "" || printTarget || printAttackMaterial || printNonTargetAttack || printApplyTarget)
-		OutFile << " [" << style; 
-
-	if (printTarget || printAttackMaterial || printNonTargetAttack || printApplyTarget)
-	{
-		OutFile << " label=\"";
-
-		if (printTarget)
-			OutFile << SkillTargetNames[(int)trigger.SkillTarget] << (printAttackMaterial || printNonTargetAttack || printApplyTarget ? "\\n" : "");
-
-		if (printAttackMaterial)
-			OutFile << "AttackMaterial: " << (int)attack->AttackMaterial << (printNonTargetAttack || printApplyTarget ? "\\n" : "");
+	out << "\t" << outRef << " -> " << Dereference(trigger.Reference);
 
-		if (printApplyTarget)
-			OutFile << "ApplyTarget: " << ApplyTargetNames[(int)attack->ApplyTarget] << "\\nCastTarget: " << ApplyTargetNames[(int)attack->CastTarget] << (printNonTargetAttack ? "\\n" : "");
+	for (GraphVariant& variant : out.Variants)
+		variant.Labels->TriggerEdge(variant.Settings.Flags, *variant.OutFile, trigger, style, afterEvent, attack);
 
-		bool targetingNone = printNonTargetAttack && (((trigger.NonTargetActive || attack->CubeMagicPathId > 0) && attack->MagicPathId == 0) || attack->ApplyTarget == ApplyTarget::None);
-
-		if (printNonTargetAttack)
-			OutFile << "No Target: " << targetingNone;
-
-		OutFile << "\" ";
-	}
-
-	if (style != "" || printTarget || printAttackMaterial || printNonTargetAttack || printApplyTarget)
-		OutFile << "]";
-
-	OutFile << "\n";
+	out << "\n";
 }
 
 void GraphData::PrintRoot(const JobSkill& jobSkill)
 {
+	GraphOutput& out = Output();
 
-	auto skillIndex = skills.find(jobSkill.Skill.Id);
+	auto skillIndex = model().Skills.find(jobSkill.Skill.Id);
 
-	if (skillIndex == skills.end())
+	if (skillIndex == model().Skills.end())
 		return;
 
 	const SkillData& skill = skillIndex->second;
 	const SkillLevelData& skillLevel = skill.Levels.begin()->second;
 
-	OutFile << "\t" << RootName << " -> " << Dereference(jobSkill.Skill) << "\n";
+	out << "\t" << RootName << " -> " << Dereference(jobSkill.Skill) << "\n";
 
 	for (int j = 0; j < jobSkill.SubSkills.size(); ++j)
-		OutFile << "\t" << Dereference(jobSkill.Skill) << " -> " << Dereference(jobSkill.SubSkills[j]) << " [dir=none color=\"blue\"]\n";
+		out << "\t" << Dereference(jobSkill.Skill) << " -> " << Dereference(jobSkill.SubSkills[j]) << " [dir=none color=\"blue\"]\n";
 
 	ReferenceData combo = jobSkill.Skill;
 
@@ -188,14 +549,14 @@ void GraphData::PrintRoot(const JobSkill& jobSkill)
 		if (alreadyVisited)
 			break;
 
-		auto comboSkillIndex = skills.find(nextCombo.Id);
+		auto comboSkillIndex = model().Skills.find(nextCombo.Id);
 
-		if (comboSkillIndex == skills.end())
+		if (comboSkillIndex == model().Skills.end())
 			break;
 
 		visitedCombos.push_back(combo.Id);
 
-		OutFile << "\t" << Dereference(combo) << " -> " << Dereference(nextCombo) << " [color=\"green\"]\n";
+		out << "\t" << Dereference(combo) << " -> " << Dereference(nextCombo) << " [color=\"green\"]\n";
 
 		combo = nextCombo;
 		comboSkill = &comboSkillIndex->second;
@@ -209,13 +570,15 @@ void GraphData::PrintRoot(const JobSkill& jobSkill)
 		if (changeSkill.Skill.Id == 0)
 			continue;
 
-		OutFile << "\t" << Dereference(jobSkill.Skill) << " -> " << Dereference(changeSkill.Skill) << " [color=\"red\"]\n";
+		out << "\t" << Dereference(jobSkill.Skill) << " -> " << Dereference(changeSkill.Skill) << " [color=\"red\"]\n";
 	}
 }
 
 void GraphData::PrintRoot(const JobData& jobData)
 {
-	OutFile << "\t" << RootName << " [label=\"" << RootLabel << "\"]\n";
+	GraphOutput& out = Output();
+
+	out << "\t" << RootName << " [label=\"" << RootLabel << "\"]\n";
 
 	for (int i = 0; i < jobData.Skills.size(); ++i)
 		PrintRoot(jobData.Skills[i]);
@@ -243,13 +606,15 @@ void GraphData::PrintRoot(const JobData& jobData)
 		if (uniqueReferences == 0)
 			continue;
 
-		OutFile << "\tLapenshards -> " << "item_" << item.Id << "\n";
-		OutFile << "\titem_" << item.Id << " [label=\"Item " << item.Id << "\\n\t" << Sanitize(item.Name) << "\\n\tLapenshard";
+		out << "\tLapenshards -> " << "item_" << item.Id << "\n";
+		out << "\titem_" << item.Id << " [label=\"Item " << item.Id << "\\n\t" << item.EscapedName << "\\n\tLapenshard";
 
-		if (item.Description != "")
-			OutFile << "\" tooltip=\"" << Sanitize(item.Description, true);
+		if (item.Description != "" && outputSettings.SidecarTooltips)
+			out << "\" id=\"item_" << item.Id;
+		else if (item.Description != "")
+			out << "\" tooltip=\"" << item.EscapedDescription;
 
-		OutFile <<  "\" shape=house]\n";
+		out <<  "\" shape=house]\n";
 
 		for (int j = 0; j < item.AdditionalEffects.size(); ++j)
 		{
@@ -258,7 +623,7 @@ void GraphData::PrintRoot(const JobData& jobData)
 			if (!effectReferences.contains(ref.Id))
 				effectReferences.insert(ref.Id);
 
-			OutFile << "\titem_" << item.Id << " -> " << Dereference(ref) << "\n";
+			out << "\titem_" << item.Id << " -> " << Dereference(ref) << "\n";
 		}
 
 		for (int j = 0; j < item.Skills.size(); ++j)
@@ -268,13 +633,14 @@ void GraphData::PrintRoot(const JobData& jobData)
 			if (!skillReferences.contains(ref.Id))
 				skillReferences.insert(ref.Id);
 
-			OutFile << "\titem_" << item.Id << " -> " << Dereference(ref) << "\n";
+			out << "\titem_" << item.Id << " -> " << Dereference(ref) << "\n";
 		}
 	}
 }
 
 void GraphData::PrintLinked()
 {
+	GraphOutput& out = Output();
 
 	int skillIndex = 0;
 	int effectIndex = 0;
@@ -288,51 +654,14 @@ void GraphData::PrintLinked()
 			ReferenceData skillRef = QueuedSkills[skillIndex];
 			int skillId = skillRef.Id;
 
-			auto skillContainerIndex = skills.find(skillId);
+			BeginLinked(skillRef, QueuedSkillDepths[skillIndex]);
 
-			if (skillContainerIndex == skills.end())
-			{
-				++skillIndex;
-
-				continue;
-			}
-
-			SkillData& skill = skillContainerIndex->second;
-
-			bool isProjectile = false;
-
-			if (skill.Levels.size() > 0)
-			{
-				SkillLevelData& skillLevel = skillRef.Level == -1 ? skill.Levels.begin()->second : skill.Levels[skillRef.Level];
-
-				for (const SkillMotion& motion : skillLevel.Motions)
-				{
-					for (const SkillAttack& attack : motion.Attacks)
-					{
-						if (attack.MagicPathId == 0)
-							continue;
+			const SkillData& skill = findModelEntry(model().Skills, skillId);
 
-						auto index = magicPaths.find(attack.MagicPathId);
-
-						if (index == magicPaths.end())
-							continue;
-
-						for (const MagicPathMove& move : index->second.Moves)
-						{
-							isProjectile = move.Velocity > 0;
-
-							if (isProjectile) break;
-						}
-
-						if (isProjectile) break;
-					}
-
-					if (isProjectile) break;
-				}
-			}
-
-			bool isSensor = !isProjectile && ReferencedSensorSkills.contains(skillId);
-			bool isSplash = ReferencedSplashSkills.contains(skillId);
+			// only projectiles depend on the level, and a level that wasn't loaded isn't one
+			bool isProjectile = skill.Levels.size() > 0 && findLevel(skill.Levels, skillRef.Level).Traits.IsProjectile;
+			bool isSensor = skill.Traits.IsSensor && !isProjectile;
+			bool isSplash = skill.Traits.IsSplash;
 			const char* typeLabel = "";
 
 			if (isProjectile)
@@ -342,85 +671,54 @@ void GraphData::PrintLinked()
 			else if (isSplash)
 				typeLabel = "Splash ";
 
-			OutFile << "\t" << Dereference(skillRef) << "[label=\"" << typeLabel << "Skill " << skillId;
+			out << "\t" << Dereference(skillRef) << "[label=\"" << typeLabel << "Skill " << skillId;
 
 			if (skillRef.Level != -1)
-				OutFile << " [" << skillRef.Level << "]";
+				out << " [" << skillRef.Level << "]";
 
 			if (skill.Name != "")
-				OutFile << "\\n" << Sanitize(skill.Name);
-
-			if (Settings.PrintTypes)
-				OutFile << "\\nType: " << skill.Type << "\\nSubType: " << skill.SubType;
+				out << "\\n" << skill.EscapedName;
 
-			if (Settings.PrintImmediateActiveSkill)
-				OutFile << "\\nImmediateActive: " << skill.ImmediateActive;
+			const SkillLevelData* nodeLevel = nullptr;
 
 			if (skill.Levels.size() > 0)
-			{
-				SkillLevelData& skillLevel = skillRef.Level == -1 ? skill.Levels.begin()->second : skill.Levels[skillRef.Level];
-
-				if (skillLevel.TotalMotionsWithPaths > 0 && Settings.PrintPaths)
-				{
-					OutFile << "\\nHas Path";
-				}
-				if (skillLevel.TotalMotionsWithCubePaths > 0 && Settings.PrintPaths)
-				{
-					OutFile << "\\nHas Cube Path";
-				}
+				nodeLevel = &findLevel(skill.Levels, skillRef.Level);
 
-				if (skillLevel.Motions.size() > 1 && Settings.PrintMotions)
-					OutFile << "\\n" << skillLevel.Motions.size() << " Motions";
-
-				if (skillLevel.TotalAttacks > 1 && Settings.PrintAttacks)
-					OutFile << "\\n" << skillLevel.TotalAttacks << " Attacks";
-			}
+			for (GraphVariant& variant : out.Variants)
+				variant.Labels->SkillNode(variant.Settings.Flags, *variant.OutFile, skill, nodeLevel);
 
 			if (isSplash)
 			{
-				if (skill.Levels.size() > 0)
-				{
-					SkillLevelData& skillLevel = skillRef.Level == -1 ? skill.Levels.begin()->second : skill.Levels[skillRef.Level];
-
-					if (skillLevel.Motions.size() > 1)
-					{
-						skillLevel.TotalAttacks += 0;
-					}
-
-					if (skillLevel.TotalAttacks > 1)
-					{
-						skillLevel.TotalAttacks += 0;
-					}
-				}
-
 				if (isProjectile)
-					OutFile << "\",shape=hexagon";
+					out << "\",shape=hexagon";
 				else if (isSensor)
-					OutFile << "\",shape=Mcircle";
+					out << "\",shape=Mcircle";
 				else
-					OutFile << "\",shape=box3d";
+					out << "\",shape=box3d";
 
 				if (skill.Levels.size() == 0)
-					OutFile << ",color=red";
+					out << ",color=red";
 			}
 			else
-				OutFile << "\",shape=box";
+				out << "\",shape=box";
 
 			if (skill.Levels.size() == 0)
 			{
 				++skillIndex;
 
-				OutFile << "]\n";
+				out << "]\n";
 
 				continue;
 			}
 
-			SkillLevelData& skillLevel = skillRef.Level == -1 ? skill.Levels.begin()->second : skill.Levels[skillRef.Level];
+			const SkillLevelData& skillLevel = findLevel(skill.Levels, skillRef.Level);
 			
-			if (skillLevel.Description != "")
-				OutFile << ",tooltip=\"" << Sanitize(skillLevel.Description, true) << "\"";
+			if (skillLevel.Description != "" && outputSettings.SidecarTooltips)
+				out << ",id=\"" << skillRef << "\"";
+			else if (skillLevel.Description != "")
+				out << ",tooltip=\"" << skillLevel.EscapedDescription << "\"";
 
-			OutFile << "]\n";
+			out << "]\n";
 
 			for (int i = 0; i < skillLevel.Passives.size(); ++i)
 			{
@@ -432,22 +730,22 @@ void GraphData::PrintLinked()
 
 			for (int m = 0; m < skillLevel.Motions.size(); ++m)
 			{
-				SkillMotion& motion = skillLevel.Motions[m];
+				const SkillMotion& motion = skillLevel.Motions[m];
 
 				if (skillIndex > rootSkills && motion.TotalPaths > 1)
 					skillIndex += 0;
 
 				for (int a = 0; a < motion.Attacks.size(); ++a)
 				{
-					SkillAttack& attack = motion.Attacks[a];
+					const SkillAttack& attack = motion.Attacks[a];
 
 					int magicPathMoves = 0;
 					int magicPathAligned = 0;
 
-					if (magicPaths.contains(attack.MagicPathId))
+					if (model().MagicPaths.contains(attack.MagicPathId))
 					{
-						magicPathMoves = (int)magicPaths[attack.MagicPathId].Moves.size();
-						magicPathAligned = magicPaths[attack.MagicPathId].Aligned;
+						magicPathMoves = (int)model().MagicPaths.at(attack.MagicPathId).Moves.size();
+						magicPathAligned = model().MagicPaths.at(attack.MagicPathId).Aligned;
 					}
 					else
 						skillIndex += 0;
@@ -466,24 +764,21 @@ void GraphData::PrintLinked()
 
 						if (trigger.IsSplash)
 						{
-							if (trigger.OnlySensingActive && !ReferencedSensorSkills.contains(trigger.Reference.Id))
-								ReferencedSensorSkills.insert(trigger.Reference.Id);
-
-							const auto& ref = skills.find(trigger.Reference.Id);
+							const auto& ref = model().Skills.find(trigger.Reference.Id);
 
-							if (ref != skills.end())
+							if (ref != model().Skills.end())
 							{
-								SkillData& data = ref->second;
+								const SkillData& data = ref->second;
 
 								const auto& ref2 = data.Levels.find(trigger.Reference.Level);
 
 								if (ref2 != data.Levels.end())
 								{
-									SkillLevelData& levelData = ref2->second;
+									const SkillLevelData& levelData = ref2->second;
 
-									for (SkillMotion& motionData : levelData.Motions)
+									for (const SkillMotion& motionData : levelData.Motions)
 									{
-										for (SkillAttack& attackData : motionData.Attacks)
+										for (const SkillAttack& attackData : motionData.Attacks)
 										{
 											if (attack.CubeMagicPathId != 0 && attackData.MagicPathId != 0)
 											{
@@ -491,15 +786,15 @@ void GraphData::PrintLinked()
 												int cubeMagicPathMoves = 0;
 												int cubeMagicPathAligned = 0;
 
-												if (magicPaths.contains(attackData.MagicPathId))
-													magicPathMoves = (int)magicPaths[attackData.MagicPathId].Moves.size();
+												if (model().MagicPaths.contains(attackData.MagicPathId))
+													magicPathMoves = (int)model().MagicPaths.at(attackData.MagicPathId).Moves.size();
 												else
 													skillIndex += 0;
 
-												if (magicPaths.contains(attack.CubeMagicPathId))
+												if (model().MagicPaths.contains(attack.CubeMagicPathId))
 												{
-													cubeMagicPathMoves = (int)magicPaths[attack.CubeMagicPathId].Moves.size();
-													cubeMagicPathAligned = magicPaths[attack.CubeMagicPathId].Aligned;
+													cubeMagicPathMoves = (int)model().MagicPaths.at(attack.CubeMagicPathId).Moves.size();
+													cubeMagicPathAligned = model().MagicPaths.at(attack.CubeMagicPathId).Aligned;
 												}
 												else
 													skillIndex += 0;
@@ -526,6 +821,8 @@ void GraphData::PrintLinked()
 				}
 			}
 
+			EndLinked();
+
 			++skillIndex;
 		}
 
@@ -534,68 +831,57 @@ void GraphData::PrintLinked()
 			ReferenceData effectRef = QueuedEffects[effectIndex];
 			int effectId = effectRef.Id;
 
-			auto effectContainerIndex = effects.find(effectId);
-
-			if (effectContainerIndex == effects.end())
-			{
-				++effectIndex;
-
-				continue;
-			}
+			BeginLinked(effectRef, QueuedEffectDepths[effectIndex]);
 
-			AdditionalEffectData& effect = effectContainerIndex->second;
+			const AdditionalEffectData& effect = findModelEntry(model().Effects, effectId);
 
-			OutFile << "\t" << Dereference(effectRef) << "[label=\"Effect " << effectId;
+			out << "\t" << Dereference(effectRef) << "[label=\"Effect " << effectId;
 
 			if (effectRef.Level != -1)
-				OutFile << " [" << effectRef.Level << "]";
+				out << " [" << effectRef.Level << "]";
 
 			if (effect.Levels.size() == 0)
 			{
-				OutFile << "\",color=red]\n";
+				out << "\",color=red]\n";
 
 				++effectIndex;
 
 				continue;
 			}
 
-			AdditionalEffectLevelData& effectLevel = effectRef.Level == -1 ? effect.Levels.begin()->second : effect.Levels[effectRef.Level];
+			const AdditionalEffectLevelData& effectLevel = findLevel(effect.Levels, effectRef.Level);
 
 			if (effectLevel.Group != 0)
-				OutFile << "\\nGroup: " << effectLevel.Group;
+				out << "\\nGroup: " << effectLevel.Group;
 
 			if (effectLevel.Name != "")
-				OutFile << "\\n" << Sanitize(effectLevel.Name);
+				out << "\\n" << effectLevel.EscapedName;
 
-			if (Settings.PrintEffectTypes)
-				OutFile << "\\nType: " << effectLevel.Type << "\\nSubType: " << effectLevel.SubType;
-
-			if (Settings.PrintReset)
-				OutFile << "\\nResetCondition: " << effectLevel.ResetCondition;
-
-			if (Settings.PrintStacks)
-				OutFile << "\\nMax Stacks: " << effectLevel.MaxStacks;
-
-			if (Settings.PrintKeepCondition)
-				OutFile << "\\nKeepCondition: " << effectLevel.KeepCondition;
+			for (GraphVariant& variant : out.Variants)
+				variant.Labels->EffectNode(variant.Settings.Flags, *variant.OutFile, effectLevel);
 
 			if (effectLevel.KeepCondition == 99)
-				OutFile << "\\nPersistent Effect\"shape=egg";
+				out << "\\nPersistent Effect\"shape=egg";
 			else
-				OutFile << "\",shape=ellipse";
+				out << "\",shape=ellipse";
 			
-			if (effectLevel.Description != "")
-				OutFile << ",tooltip=\"" << Sanitize(effectLevel.Description, true) << "\"";
+			if (effectLevel.Description != "" && outputSettings.SidecarTooltips)
+				out << ",id=\"" << effectRef << "\"";
+			else if (effectLevel.Description != "")
+				out << ",tooltip=\"" << effectLevel.EscapedDescription << "\"";
 
-			OutFile << "]\n";
+			out << "]\n";
 
 			if (effectLevel.Group != 0)
 			{
-				if (effects.contains(effectLevel.Group))
-					OutFile << "\t" << Dereference(effectRef) << " -> " << Dereference(ReferenceData{ ReferenceType::Effect, effectLevel.Group, -1 }) << "[constraint=false,style=dashed,arrowhead=dot,color=green]\n";
+				if (model().Effects.contains(effectLevel.Group))
+				{
+					if (Admit(ReferenceData{ ReferenceType::Effect, effectLevel.Group, -1 }))
+						out << "\t" << Dereference(effectRef) << " -> " << Dereference(ReferenceData{ ReferenceType::Effect, effectLevel.Group, -1 }) << "[constraint=false,style=dashed,arrowhead=dot,color=green]\n";
+				}
 				else
 				{
-					OutFile << "\t" << Dereference(effectRef) << " -> effectgroup_" << effectLevel.Group << "[style=dashed,arrowhead=dot,color=green]\n";
+					out << "\t" << Dereference(effectRef) << " -> effectgroup_" << effectLevel.Group << "[style=dashed,arrowhead=dot,color=green]\n";
 
 					if (!ReferencedEffectGroups.contains(effectLevel.Group))
 						ReferencedEffectGroups.insert(effectLevel.Group);
@@ -611,16 +897,19 @@ void GraphData::PrintLinked()
 			{
 				const ModifyReference& mod = effectLevel.Modifications[i];
 
+				if (mod.ModificationType != ModifyReferenceType::ModifyDuration && !Admit(mod))
+					continue;
+
 				if (mod.ModificationType == ModifyReferenceType::ModifyStacks)
 				{
-					OutFile << "\t" << Dereference(effectRef) << " -> " << Dereference(mod);
+					out << "\t" << Dereference(effectRef) << " -> " << Dereference(mod);
 					
 					if (mod.Offset > 0)
-						OutFile << "[style=dashed,arrowhead=olnormal,color=chartreuse4,label=\"+";
+						out << "[style=dashed,arrowhead=olnormal,color=chartreuse4,label=\"+";
 					else
-						OutFile << "[style=dashed,arrowhead=ornormal,color=darkred,label=\"";
+						out << "[style=dashed,arrowhead=ornormal,color=darkred,label=\"";
 
-					OutFile << mod.Offset << "\"]\n";
+					out << mod.Offset << "\"]\n";
 				}
 				else if (mod.ModificationType == ModifyReferenceType::ModifyDuration)
 				{
@@ -628,67 +917,176 @@ void GraphData::PrintLinked()
 				}
 				else if (mod.ModificationType == ModifyReferenceType::Cancel)
 				{
-					OutFile << "\t" << Dereference(effectRef) << " -> " << Dereference(mod) << " [style=dotted,arrowhead=vee,color=red]\n";
+					out << "\t" << Dereference(effectRef) << " -> " << Dereference(mod) << " [style=dotted,arrowhead=vee,color=red]\n";
 				}
 				else if (mod.ModificationType == ModifyReferenceType::Immune)
 				{
-					OutFile << "\t" << Dereference(effectRef) << " -> " << Dereference(mod) << " [style=dotted,arrowhead=tee,color=darkred]\n";
+					out << "\t" << Dereference(effectRef) << " -> " << Dereference(mod) << " [style=dotted,arrowhead=tee,color=darkred]\n";
 				}
 			}
 
-			if (Settings.PrintRequireSkillCodeConnections)
+			if (Settings.Has(PrintFlag::RequireSkillCodeConnections))
 			{
 				std::string constraint = effectLevel.Condition.RequireSkillCodes.size() > 5 ? "constraint=false," : "";
 
 				for (int skillId : effectLevel.Condition.RequireSkillCodes)
 				{
-					OutFile << "\t" << Dereference(ReferenceData{ ReferenceType::Skill, skillId, 1 }) << " -> " << Dereference(effectRef) << " [" << constraint << "style=dashed,arrowhead=vee,color=cyan]\n";
+					if (!Admit(ReferenceData{ ReferenceType::Skill, skillId, 1 }))
+						continue;
+
+					out << "\t" << Dereference(ReferenceData{ ReferenceType::Skill, skillId, 1 }) << " -> " << Dereference(effectRef) << " [" << constraint << "style=dashed,arrowhead=vee,color=cyan]\n";
 				}
 			}
 
+			EndLinked();
+
 			++effectIndex;
 		}
 	}
 
 	for (int group : ReferencedEffectGroups)
-		OutFile << "\teffectgroup_" << group << "[label=\"Group " << group << "\",shape=octagon]\n";
+		out << "\teffectgroup_" << group << "[label=\"Group " << group << "\",shape=octagon]\n";
 }
 
 void GraphData::PrintRoot(const SetBonusData& setData)
 {
-	OutFile << "\t" << RootName << " [label=\"" << RootLabel << "\"]\n";
+	GraphOutput& out = Output();
+
+	out << "\t" << RootName << " [label=\"" << RootLabel << "\"]\n";
 
 	for (int i = 0; i < setData.OptionData->Parts.size(); ++i)
 	{
 		const SetBonusOptionPartData& part = setData.OptionData->Parts[i];
 
-		OutFile << "\tset_" << part.Count << " [label=\"" << part.Count << " Piece Bonus\" shape=invhouse]\n";
-		OutFile << "\t" << RootName << " -> set_" << part.Count << "\n";
+		out << "\tset_" << part.Count << " [label=\"" << part.Count << " Piece Bonus\" shape=invhouse]\n";
+		out << "\t" << RootName << " -> set_" << part.Count << "\n";
 
 		for (int j = 0; j < part.AdditionalEffects.size(); ++j)
-			OutFile << "\tset_" << part.Count << " -> " << Dereference(part.AdditionalEffects[j]) << "\n";
+			out << "\tset_" << part.Count << " -> " << Dereference(part.AdditionalEffects[j]) << "\n";
 	}
 
 	for (int i = 0; i < setData.ItemIds.size(); ++i)
 	{
 		int itemId = setData.ItemIds[i];
 
-		const auto& itemIndex = items.find(itemId);
+		const auto& itemIndex = model().Items.find(itemId);
 
-		if (itemIndex == items.end())
+		if (itemIndex == model().Items.end())
 			continue;
 
 		const ItemData& item = itemIndex->second;
 
-		OutFile << "\titem_" << itemId << " [label=\"Item " << itemId << "\\n" << Sanitize(item.Name) << "\\n" << item.Class;
+		out << "\titem_" << itemId << " [label=\"Item " << itemId << "\\n" << item.EscapedName << "\\n" << item.Class;
 
-		if (item.Description != "")
-			OutFile << "\" tooltip=\"" << Sanitize(item.Description, true);
+		if (item.Description != "" && outputSettings.SidecarTooltips)
+			out << "\" id=\"item_" << itemId;
+		else if (item.Description != "")
+			out << "\" tooltip=\"" << item.EscapedDescription;
 
-		OutFile << "\" shape=house]\n";
-		OutFile << "\t" << RootName << " -> " << "item_" << itemId << "\n";
+		out << "\" shape=house]\n";
+		out << "\t" << RootName << " -> " << "item_" << itemId << "\n";
 		
 		for (int j = 0; j < item.AdditionalEffects.size(); ++j)
-			OutFile << "\titem_" << itemId << " -> " << Dereference(item.AdditionalEffects[j]) << "\n";
+			out << "\titem_" << itemId << " -> " << Dereference(item.AdditionalEffects[j]) << "\n";
+	}
+}
+
+void GraphData::PrintRoot(const ReferenceData& reference)
+{
+	CurrentDepth = -1;
+
+	Dereference(reference);
+
+	CurrentDepth = 0;
+}
+
+bool findGraphRoot(const GraphPackKey& key, GraphRoot& root)
+{
+	if (key.Kind == GraphPackKind::ClassKit)
+	{
+		auto jobIndex = model().Jobs.find((JobCode)key.Id);
+
+		if (jobIndex == model().Jobs.end())
+			return false;
+
+		const JobData& job = jobIndex->second;
+
+		std::string jobName = job.Name;
+
+		for (int i = 0; i < jobName.size(); ++i)
+			if (jobName[i] == ' ')
+				jobName[i] = '_';
+
+		root = GraphRoot{ jobName, jobName, job.Name, "digraph " + jobName + "_Kit {\n", [&job](GraphData& graphData)
+		{
+			graphData.PrintRoot(job);
+
+			graphData.PrintLinked();
+		} };
+
+		return true;
+	}
+
+	if (key.Kind == GraphPackKind::SetBonus)
+	{
+		auto setIndex = model().SetBonuses.find(key.Id);
+
+		if (setIndex == model().SetBonuses.end())
+			return false;
+
+		const SetBonusData& setData = setIndex->second;
+
+		std::string setName = Desanitize(setData.Name);
+		std::string setVarName = setName;
+
+		for (int i = 0; i < setVarName.size(); ++i)
+			if (setVarName[i] == ' ' || setVarName[i] == '(' || setVarName[i] == ')' || setVarName[i] == '\'')
+				setVarName[i] = '_';
+
+		root = GraphRoot{ std::to_string(key.Id) + "_" + setVarName, setVarName, setName, "digraph " + setVarName + "_Kit {\n", [&setData](GraphData& graphData)
+		{
+			graphData.PrintRoot(setData);
+			graphData.PrintLinked();
+		} };
+
+		return true;
 	}
+
+	ReferenceData reference{ key.Kind == GraphPackKind::SkillDetail ? ReferenceType::Skill : ReferenceType::Effect, key.Id, key.Level };
+
+	std::stringstream nameStream;
+
+	nameStream << reference;
+
+	std::string name = nameStream.str();
+
+	root = GraphRoot{ name, name, name, "digraph " + name + "_Detail {\n", [reference](GraphData& graphData)
+	{
+		graphData.DetailUrlPrefix = "";
+
+		graphData.PrintRoot(reference);
+		graphData.PrintLinked();
+	} };
+
+	return true;
+}
+
+bool printGraphText(const GraphPackKey& key, const GraphPrintSettings& settings, std::ostream& out)
+{
+	GraphRoot root;
+
+	if (!findGraphRoot(key, root))
+		return false;
+
+	GraphData graphData{ out, root.RootName, root.RootLabel };
+
+	graphData.Settings = settings;
+
+	out << root.Header;
+
+	root.Print(graphData);
+
+	out << "}\n";
+
+	return true;
 }
\ No newline at end of file
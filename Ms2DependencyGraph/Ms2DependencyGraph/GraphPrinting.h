@@ -1,37 +1,146 @@
 #pragma once
 
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <functional>
+#include <string_view>
 #include <unordered_set>
+#include <vector>
 
 #include "XmlData.h"
+#include "GraphPack.h"
+
+// Zero leaves a limit off. Nodes past a limit are folded into a summary node that links to their own detail graph.
+struct GraphTraversalLimits
+{
+	int MaxDepth = 0;
+	int MaxNodes = 0;
+	int MaxFanOut = 0;
+
+	bool IsLimited() const { return MaxDepth > 0 || MaxNodes > 0 || MaxFanOut > 0; }
+};
+
+extern GraphTraversalLimits traversalLimits;
+
+namespace fs = std::filesystem;
+
+// Optional parts of node and edge labels, and the require skill code edges.
+enum class PrintFlag : uint32_t
+{
+	Types = 1 << 0,
+	EffectTypes = 1 << 1,
+	Paths = 1 << 2,
+	Reset = 1 << 3,
+	KeepCondition = 1 << 4,
+	Stacks = 1 << 5,
+	Motions = 1 << 6,
+	Attacks = 1 << 7,
+	Targets = 1 << 8,
+	ImmediateActiveSkill = 1 << 9,
+	Target = 1 << 10,
+	RequireSkillCodeConnections = 1 << 11,
+	AttackMaterial = 1 << 12,
+	NonTargetAttack = 1 << 13,
+	ApplyTarget = 1 << 14
+};
+
+constexpr uint32_t operator|(PrintFlag left, PrintFlag right) { return (uint32_t)left | (uint32_t)right; }
+constexpr uint32_t operator|(uint32_t left, PrintFlag right) { return left | (uint32_t)right; }
+
+constexpr uint32_t defaultPrintFlags = PrintFlag::Types | PrintFlag::EffectTypes | PrintFlag::Reset | PrintFlag::KeepCondition | PrintFlag::Stacks | PrintFlag::Targets |
+	PrintFlag::ImmediateActiveSkill | PrintFlag::Target | PrintFlag::AttackMaterial | PrintFlag::NonTargetAttack | PrintFlag::ApplyTarget;
+constexpr uint32_t compactPrintFlags = PrintFlag::Targets | PrintFlag::Target;
+constexpr uint32_t detailedPrintFlags = defaultPrintFlags | PrintFlag::Paths | PrintFlag::Motions | PrintFlag::Attacks;
+
+struct GraphPrintSettings
+{
+	uint32_t Flags = defaultPrintFlags;
+
+	bool Has(PrintFlag flag) const { return (Flags & (uint32_t)flag) != 0; }
+	void Set(PrintFlag flag, bool enabled) { Flags = enabled ? Flags | (uint32_t)flag : Flags & ~(uint32_t)flag; }
+};
+
+extern GraphPrintSettings printSettings;
+
+// Reads a list separated by commas, spaces or new lines. A preset name (default, compact, detailed) replaces every flag,
+// "name" or "+name" turns one on, "-name" turns it off and "name=0" or "name=1" sets it. Lines in a file may end in a
+// '#' comment.
+bool readPrintSettings(std::string_view text, GraphPrintSettings& settings);
+bool loadPrintSettings(const fs::path& filePath, GraphPrintSettings& settings);
+
+// Flags fixed at compile time, so the labels written for a preset have their flag checks folded away.
+template <uint32_t Flags>
+struct StaticPrintFlags
+{
+	constexpr StaticPrintFlags(uint32_t) {}
+
+	constexpr bool operator()(PrintFlag flag) const { return (Flags & (uint32_t)flag) != 0; }
+};
+
+struct RuntimePrintFlags
+{
+	uint32_t Flags = 0;
+
+	RuntimePrintFlags(uint32_t flags) : Flags(flags) {}
+
+	bool operator()(PrintFlag flag) const { return (Flags & (uint32_t)flag) != 0; }
+};
+
+// The parts of the output that depend on the print flags. Everything else in a graph comes from the traversal and is
+// the same for every set of flags.
+struct GraphLabelWriter
+{
+	void (*EventEdge)(uint32_t flags, std::ostream& out, const ConditionSkill& trigger);
+	void (*CastEdge)(uint32_t flags, std::ostream& out, const ConditionSkill& trigger, bool afterEvent);
+	void (*TriggerEdge)(uint32_t flags, std::ostream& out, const ConditionSkill& trigger, const std::string& style, bool afterEvent, const SkillAttack* attack);
+	void (*SkillNode)(uint32_t flags, std::ostream& out, const SkillData& skill, const SkillLevelData* skillLevel);
+	void (*EffectNode)(uint32_t flags, std::ostream& out, const AdditionalEffectLevelData& effectLevel);
+};
+
+// the writer specialized for flags when they match a preset, or the one that checks each flag
+const GraphLabelWriter& getLabelWriter(uint32_t flags);
+
+// Flags that change which edges are followed rather than how they are labeled. Variants printed from one traversal have
+// to agree on these.
+constexpr uint32_t structuralPrintFlags = (uint32_t)PrintFlag::RequireSkillCodeConnections;
+
+struct GraphVariant
+{
+	std::ostream* OutFile = nullptr;
+	GraphPrintSettings Settings;
+	const GraphLabelWriter* Labels = nullptr;
+};
+
+// Sends everything but the labels to each variant's stream.
+struct GraphOutput
+{
+	std::vector<GraphVariant> Variants;
+
+	template <typename T>
+	GraphOutput& operator<<(const T& value)
+	{
+		for (GraphVariant& variant : Variants)
+			*variant.OutFile << value;
+
+		return *this;
+	}
+};
 
 struct GraphData
 {
-	std::ofstream& OutFile;
+	std::ostream& OutFile;
 	std::string RootName;
 	std::string RootLabel;
 
-	struct PrintSettings
-	{
-		bool PrintTypes = true;
-		bool PrintEffectTypes = true;
-		bool PrintPaths = false;
-		bool PrintReset = true;
-		bool PrintKeepCondition = true;
-		bool PrintStacks = true;
-		bool PrintMotions = false;
-		bool PrintAttacks = false;
-		bool PrintTargets = true;
-		bool PrintImmediateActiveSkill = true;
-		bool PrintTarget = true;
-		bool PrintRequireSkillCodeConnections = false;
-		bool PrintAttackMaterial = true;
-		bool PrintNonTargetAttack = true;
-		bool PrintApplyTarget = true;
-	};
+	using PrintSettings = GraphPrintSettings;
+
+	PrintSettings Settings = printSettings;
+
+	// OutFile with Settings comes first, followed by any variants added before printing
+	GraphOutput Out;
 
-	PrintSettings Settings;
+	GraphTraversalLimits Limits = traversalLimits;
 
 	struct References
 	{
@@ -41,16 +150,47 @@ struct GraphData
 
 	std::unordered_map<int, References> ReferencedSkills;
 	std::unordered_map<int, References> ReferencedEffects;
-	std::unordered_set<int> ReferencedSplashSkills;
-	std::unordered_set<int> ReferencedSensorSkills;
 	std::unordered_set<int> ReferencedEffectGroups;
 	std::vector<ReferenceData> QueuedSkills;
 	std::vector<ReferenceData> QueuedEffects;
+	std::vector<int> QueuedSkillDepths;
+	std::vector<int> QueuedEffectDepths;
 
-	const ReferenceData& Dereference(const ReferenceData& reference, bool isSplash = false);
+	// references that were not followed because of the traversal limits, grouped under the node that referenced them
+	ReferenceData CurrentReference;
+	int CurrentDepth = 0;
+	int CurrentFanOut = 0;
+	std::unordered_set<int> CollapsedSkills;
+	std::unordered_set<int> CollapsedEffects;
+	std::vector<ReferenceData> CollapsedNodes;
+	std::string DetailUrlPrefix = "details/";
+
+	const ReferenceData& Dereference(const ReferenceData& reference);
+	bool Admit(const ReferenceData& reference);
+	void BeginLinked(const ReferenceData& reference, int depth);
+	void EndLinked();
+	GraphOutput& Output();
+	void AddVariant(std::ostream& outFile, const GraphPrintSettings& settings);
 	void Print(const ReferenceData& caller, const ConditionSkill& trigger, const std::string& style = "", int index1 = -1, int index2 = -1, const SkillAttack* attack = nullptr);
 	void PrintRoot(const JobSkill& jobSkill);
 	void PrintRoot(const JobData& jobData);
 	void PrintLinked();
 	void PrintRoot(const SetBonusData& setData);
-};
\ No newline at end of file
+	void PrintRoot(const ReferenceData& reference);
+};
+
+// What a class kit, set bonus or detail graph is named and printed from.
+struct GraphRoot
+{
+	std::string FileName;
+	std::string RootName;
+	std::string RootLabel;
+	std::string Header;
+	std::function<void(GraphData&)> Print;
+};
+
+// false when the key's job or set isn't in the model; skills and effects that weren't loaded print as missing nodes
+bool findGraphRoot(const GraphPackKey& key, GraphRoot& root);
+
+// The whole document for one graph, printed with settings and without splitting or writing it.
+bool printGraphText(const GraphPackKey& key, const GraphPrintSettings& settings, std::ostream& out);
\ No newline at end of file
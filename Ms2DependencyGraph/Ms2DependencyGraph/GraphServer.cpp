@@ -0,0 +1,414 @@
+#include "GraphServer.h"
+
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <WinSock2.h>
+#include <afunix.h>
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include "XmlParsing.h"
+#include "GraphPrinting.h"
+#include "ReferenceIndex.h"
+#include "IngestStats.h"
+
+namespace
+{
+#ifdef _WIN32
+	using SocketHandle = SOCKET;
+
+	const SocketHandle invalidSocket = INVALID_SOCKET;
+
+	void closeSocket(SocketHandle socket)
+	{
+		closesocket(socket);
+	}
+#else
+	using SocketHandle = int;
+
+	const SocketHandle invalidSocket = -1;
+
+	void closeSocket(SocketHandle socket)
+	{
+		close(socket);
+	}
+#endif
+
+	// A loaded model and what the server derives from it. Queries hold on to the one that was current when they started,
+	// so a reload never frees a model that is still being read.
+	struct ServedModel
+	{
+		std::unique_ptr<GraphModel> Model = std::make_unique<GraphModel>();
+		ReferenceIndex Referrers;
+		int Generation = 0;
+	};
+
+	std::function<bool()> loadModel;
+
+	// only held long enough to copy or replace the pointer, never while a model loads or a query runs
+	std::mutex currentLock;
+	std::shared_ptr<const ServedModel> currentModel;
+
+	std::mutex reloadLock;
+
+	std::shared_ptr<const ServedModel> acquireModel()
+	{
+		std::lock_guard<std::mutex> guard(currentLock);
+
+		return currentModel;
+	}
+
+	// points model() at a snapshot for the calling thread
+	struct ModelScope
+	{
+		std::shared_ptr<const ServedModel> Served = acquireModel();
+
+		ModelScope() { threadModel = Served->Model.get(); }
+		~ModelScope() { threadModel = nullptr; }
+	};
+
+	bool reload(std::string& reply)
+	{
+		std::lock_guard<std::mutex> guard(reloadLock);
+
+		std::shared_ptr<ServedModel> served = std::make_shared<ServedModel>();
+		std::shared_ptr<const ServedModel> previous = acquireModel();
+		GraphModel* previousShared = sharedModel;
+
+		// the loader and the pool threads it uses fill whatever sharedModel points at
+		sharedModel = served->Model.get();
+
+		ingestStats.PrefetchStages.clear();
+
+		if (!loadModel())
+		{
+			sharedModel = previousShared;
+			reply = "couldn't load the model\n";
+
+			return false;
+		}
+
+		served->Referrers.Build();
+		served->Generation = previous != nullptr ? previous->Generation + 1 : 0;
+
+		{
+			std::lock_guard<std::mutex> currentGuard(currentLock);
+
+			currentModel = served;
+		}
+
+		reply = "loaded model " + std::to_string(served->Generation) + "\n";
+
+		return true;
+	}
+
+	bool readNode(std::string_view text, GraphNodeId& node)
+	{
+		static const std::pair<std::string_view, GraphNodeType> types[] = {
+			{ "skill", GraphNodeType::Skill },
+			{ "effect", GraphNodeType::Effect },
+			{ "item", GraphNodeType::Item },
+			{ "set", GraphNodeType::SetBonus },
+			{ "job", GraphNodeType::Job }
+		};
+
+		size_t separator = text.find(':');
+
+		if (separator == std::string_view::npos)
+			return false;
+
+		for (const auto& type : types)
+		{
+			if (text.substr(0, separator) != type.first)
+				continue;
+
+			node = GraphNodeId{ type.second, atoi(std::string(text.substr(separator + 1)).c_str()) };
+
+			return true;
+		}
+
+		return false;
+	}
+
+	void writeNode(std::ostream& out, const GraphNodeId& node)
+	{
+		static const char* prefixes[] = { "skill_", "effect_", "item_", "set_", "job_" };
+
+		out << prefixes[(int)node.Type] << node.Id << "\n";
+	}
+
+	bool answer(const std::string& command, const std::string& target, const std::string& settingsText, std::string& reply)
+	{
+		ModelScope scope;
+
+		std::stringstream out;
+
+		if (command == "graph")
+		{
+			GraphPackKey key;
+			GraphPrintSettings settings = printSettings;
+
+			if (!readGraphPackKey(target.c_str(), key))
+			{
+				reply = "unknown graph: " + target + "\n";
+
+				return false;
+			}
+
+			if (!readPrintSettings(settingsText, settings))
+			{
+				reply = "unknown print settings: " + settingsText + "\n";
+
+				return false;
+			}
+
+			if (!printGraphText(key, settings, out))
+			{
+				reply = "graph isn't in the model: " + target + "\n";
+
+				return false;
+			}
+
+			reply = out.str();
+
+			return true;
+		}
+
+		if (command == "refs")
+		{
+			GraphNodeId node;
+
+			if (!readNode(target, node))
+			{
+				reply = "unknown node: " + target + "\n";
+
+				return false;
+			}
+
+			for (const GraphNodeId& referrer : scope.Served->Referrers.GetReferrers(node))
+				writeNode(out, referrer);
+
+			reply = out.str();
+
+			return true;
+		}
+
+		reply = "unknown request: " + command + "\n";
+
+		return false;
+	}
+
+	// false for quit
+	bool handleRequest(const std::string& line, const std::function<void(bool succeeded, const std::string& reply)>& respond)
+	{
+		std::istringstream request(line);
+		std::string command;
+		std::string target;
+		std::string settingsText;
+
+		request >> command >> target;
+
+		std::getline(request, settingsText);
+
+		if (command == "quit")
+			return false;
+
+		std::string reply;
+		bool succeeded = command == "reload" ? reload(reply) : answer(command, target, settingsText, reply);
+
+		respond(succeeded, reply);
+
+		return true;
+	}
+
+	void writeReply(std::ostream& out, bool succeeded, const std::string& reply)
+	{
+		out << (succeeded ? "ok " : "error ") << reply.size() << "\n" << reply;
+		out.flush();
+	}
+
+	int serveStdio(std::ostream& replies)
+	{
+		std::mutex replyLock;
+		std::vector<std::thread> reloads;
+
+		const auto respond = [&replies, &replyLock](bool succeeded, const std::string& reply)
+		{
+			std::lock_guard<std::mutex> guard(replyLock);
+
+			writeReply(replies, succeeded, reply);
+		};
+
+		std::string line;
+
+		while (std::getline(std::cin, line))
+		{
+			if (line.size() > 0 && line.back() == '\r')
+				line.pop_back();
+
+			if (line.empty())
+				continue;
+
+			if (line.rfind("reload", 0) == 0)
+			{
+				reloads.push_back(std::thread([line, respond]() { handleRequest(line, respond); }));
+
+				continue;
+			}
+
+			if (!handleRequest(line, respond))
+				break;
+		}
+
+		for (std::thread& reload : reloads)
+			reload.join();
+
+		return 0;
+	}
+
+	void serveConnection(SocketHandle connection)
+	{
+		std::string buffer;
+		char received[4096];
+
+		const auto respond = [connection](bool succeeded, const std::string& reply)
+		{
+			std::stringstream out;
+
+			writeReply(out, succeeded, reply);
+
+			std::string text = out.str();
+
+			for (size_t sent = 0; sent < text.size();)
+			{
+				int count = (int)send(connection, text.data() + sent, (int)(text.size() - sent), 0);
+
+				if (count <= 0)
+					return;
+
+				sent += (size_t)count;
+			}
+		};
+
+		bool open = true;
+
+		while (open)
+		{
+			int count = (int)recv(connection, received, sizeof(received), 0);
+
+			if (count <= 0)
+				break;
+
+			buffer.append(received, (size_t)count);
+
+			for (size_t lineEnd = buffer.find('\n'); open && lineEnd != std::string::npos; lineEnd = buffer.find('\n'))
+			{
+				std::string line = buffer.substr(0, lineEnd);
+
+				buffer.erase(0, lineEnd + 1);
+
+				if (line.size() > 0 && line.back() == '\r')
+					line.pop_back();
+
+				if (!line.empty())
+					open = handleRequest(line, respond);
+			}
+		}
+
+		closeSocket(connection);
+	}
+
+	int serveSocket(const std::string& socketPath)
+	{
+#ifdef _WIN32
+		WSADATA winsockData;
+
+		if (WSAStartup(MAKEWORD(2, 2), &winsockData) != 0)
+			return -1;
+#endif
+
+		SocketHandle listener = socket(AF_UNIX, SOCK_STREAM, 0);
+
+		if (listener == invalidSocket)
+		{
+			std::cout << "couldn't create socket" << std::endl;
+
+			return -1;
+		}
+
+		sockaddr_un address = {};
+
+		address.sun_family = AF_UNIX;
+
+		if (socketPath.size() >= sizeof(address.sun_path))
+		{
+			std::cout << "socket path is too long: " << socketPath << std::endl;
+
+			return -1;
+		}
+
+		socketPath.copy(address.sun_path, socketPath.size());
+
+		// a socket file left by an earlier server that wasn't shut down would fail the bind
+		std::error_code error;
+
+		fs::remove(socketPath, error);
+
+		if (bind(listener, (const sockaddr*)&address, sizeof(address)) != 0 || listen(listener, 16) != 0)
+		{
+			std::cout << "couldn't listen on: " << socketPath << std::endl;
+
+			closeSocket(listener);
+
+			return -1;
+		}
+
+		std::cout << "serving graphs on " << socketPath << std::endl;
+
+		while (true)
+		{
+			SocketHandle connection = accept(listener, nullptr, nullptr);
+
+			if (connection == invalidSocket)
+				continue;
+
+			std::thread(serveConnection, connection).detach();
+		}
+	}
+}
+
+int serveGraphs(const std::string& address, const std::function<bool()>& load)
+{
+	loadModel = load;
+
+	// replies own stdout on stdin, so everything else printed is moved to stderr
+	bool stdio = address == "stdio";
+	std::ostream replies(std::cout.rdbuf());
+
+	if (stdio)
+		std::cout.rdbuf(std::cerr.rdbuf());
+
+	std::string reply;
+	bool loaded = reload(reply);
+
+	std::cout << reply;
+
+	int result = !loaded ? -1 : stdio ? serveStdio(replies) : serveSocket(address);
+
+	std::cout.rdbuf(replies.rdbuf());
+
+	return result;
+}
\ No newline at end of file
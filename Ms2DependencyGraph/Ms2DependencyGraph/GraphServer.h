@@ -0,0 +1,16 @@
+#pragma once
+
+#include <functional>
+#include <string>
+
+// Answers graph requests from a model that stays loaded, over stdin and stdout or a local socket. One request a line:
+//   graph <key> [print settings]   the digraph for a graph pack key such as "kit:90", "set:123" or "skill:10000123:1",
+//                                  printed with the --print settings changed by the list after it
+//   refs <skill|effect|item|set|job>:<id>   the nodes that refer to one, a line each
+//   reload                         loads a new model; queries keep reading the old one until it is ready
+//   quit                           ends the connection
+// Each reply is "ok <length>" or "error <length>" on a line of its own, followed by length bytes.
+// Every socket connection gets a thread. On stdin requests are answered in order, except that a reload runs on a thread
+// of its own and replies when it finishes, and anything the loaders print goes to stderr instead.
+// load fills model(); address is "stdio" or the path of the socket to listen on.
+int serveGraphs(const std::string& address, const std::function<bool()>& load);
\ No newline at end of file
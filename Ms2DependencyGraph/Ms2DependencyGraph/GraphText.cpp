@@ -0,0 +1,154 @@
+#include "GraphText.h"
+
+#include <algorithm>
+
+namespace
+{
+	std::string_view readIdentifier(std::string_view line, size_t& index)
+	{
+		size_t start = index;
+
+		while (index < line.size() && line[index] != ' ' && line[index] != '[' && line[index] != '\t')
+			++index;
+
+		return line.substr(start, index - start);
+	}
+
+	void skipSpaces(std::string_view line, size_t& index)
+	{
+		while (index < line.size() && (line[index] == ' ' || line[index] == '\t'))
+			++index;
+	}
+}
+
+bool GraphText::Parse(std::string_view text)
+{
+	Statements.clear();
+
+	size_t lineStart = 0;
+	bool foundHeader = false;
+
+	while (lineStart < text.size())
+	{
+		size_t lineEnd = text.find('\n', lineStart);
+
+		if (lineEnd == std::string_view::npos)
+			lineEnd = text.size();
+
+		std::string_view line = text.substr(lineStart, lineEnd - lineStart);
+
+		lineStart = lineEnd + 1;
+
+		if (!foundHeader)
+		{
+			if (line.substr(0, 8) != "digraph ")
+				return false;
+
+			size_t nameEnd = line.find(' ', 8);
+
+			Name = line.substr(8, nameEnd == std::string_view::npos ? std::string_view::npos : nameEnd - 8);
+			foundHeader = true;
+
+			continue;
+		}
+
+		if (line.size() == 0 || line[0] != '\t')
+			continue;
+
+		line = line.substr(1);
+
+		GraphStatement statement;
+		size_t index = 0;
+
+		statement.Text = line;
+		statement.From = readIdentifier(line, index);
+
+		skipSpaces(line, index);
+
+		if (line.substr(index, 2) == "->")
+		{
+			index += 2;
+
+			skipSpaces(line, index);
+
+			statement.To = readIdentifier(line, index);
+		}
+
+		size_t attributesStart = line.find('[', index);
+		size_t attributesEnd = line.rfind(']');
+
+		if (attributesStart != std::string_view::npos && attributesEnd != std::string_view::npos && attributesEnd > attributesStart)
+			statement.Attributes = line.substr(attributesStart + 1, attributesEnd - attributesStart - 1);
+
+		if (statement.From.size() > 0)
+			Statements.push_back(statement);
+	}
+
+	return foundHeader;
+}
+
+void readGraphAttributes(std::string_view attributes, std::vector<GraphAttribute>& output)
+{
+	output.clear();
+
+	size_t index = 0;
+
+	while (index < attributes.size())
+	{
+		while (index < attributes.size() && (attributes[index] == ' ' || attributes[index] == ',' || attributes[index] == '\t'))
+			++index;
+
+		size_t nameStart = index;
+
+		while (index < attributes.size() && attributes[index] != '=' && attributes[index] != ' ' && attributes[index] != ',')
+			++index;
+
+		GraphAttribute attribute;
+
+		attribute.Name = attributes.substr(nameStart, index - nameStart);
+
+		if (index >= attributes.size() || attributes[index] != '=')
+		{
+			if (attribute.Name.size() > 0)
+				output.push_back(attribute);
+
+			continue;
+		}
+
+		++index;
+
+		if (index < attributes.size() && attributes[index] == '"')
+		{
+			size_t valueStart = ++index;
+
+			while (index < attributes.size() && attributes[index] != '"')
+				index += attributes[index] == '\\' ? 2 : 1;
+
+			index = std::min(index, attributes.size());
+
+			attribute.Value = attributes.substr(valueStart, index - valueStart);
+
+			++index;
+		}
+		else
+		{
+			size_t valueStart = index;
+
+			while (index < attributes.size() && attributes[index] != ' ' && attributes[index] != ',')
+				++index;
+
+			attribute.Value = attributes.substr(valueStart, index - valueStart);
+		}
+
+		output.push_back(attribute);
+	}
+}
+
+std::string_view findGraphAttribute(const std::vector<GraphAttribute>& attributes, std::string_view name, std::string_view defaultValue)
+{
+	for (const GraphAttribute& attribute : attributes)
+		if (attribute.Name == name)
+			return attribute.Value;
+
+	return defaultValue;
+}
\ No newline at end of file
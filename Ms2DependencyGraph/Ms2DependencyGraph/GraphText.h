@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Statement level view over the digraph text GraphData emits: one statement per line, each either a node or a single edge.
+struct GraphStatement
+{
+	std::string_view Text;
+	std::string_view From;
+	std::string_view To;
+	std::string_view Attributes;
+
+	bool IsEdge() const { return To.size() > 0; }
+};
+
+struct GraphText
+{
+	std::string_view Name;
+	std::vector<GraphStatement> Statements;
+
+	bool Parse(std::string_view text);
+};
+
+struct GraphAttribute
+{
+	std::string_view Name;
+	std::string_view Value;
+};
+
+// Splits an attribute list into name/value pairs. Quoted values are returned without their quotes but still escaped.
+void readGraphAttributes(std::string_view attributes, std::vector<GraphAttribute>& output);
+std::string_view findGraphAttribute(const std::vector<GraphAttribute>& attributes, std::string_view name, std::string_view defaultValue = "");
\ No newline at end of file
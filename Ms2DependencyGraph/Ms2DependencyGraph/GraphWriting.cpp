@@ -0,0 +1,263 @@
+#include "GraphWriting.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <sstream>
+
+#include "GraphText.h"
+#include "GraphPartitioning.h"
+#include "GraphLayout.h"
+#include "ThreadPool.h"
+#include "OutputWriter.h"
+#include "Deflate.h"
+
+GraphOutputSettings outputSettings;
+
+namespace
+{
+	// Layouts and compression run on the pool, which queues without a limit, and each task holds its graph's whole text.
+	// Generation waits once as many are in flight as the write queue holds, so it can't run ahead of them.
+	class PendingDocuments
+	{
+	public:
+		void Queue(std::function<void()> task)
+		{
+			{
+				std::unique_lock<std::mutex> guard(Lock);
+
+				int maxInFlight = std::max(1, outputSettings.WriteQueueLength);
+
+				if (InFlight >= maxInFlight)
+				{
+					std::chrono::steady_clock::time_point waitStart = std::chrono::steady_clock::now();
+
+					Finished.wait(guard, [this, maxInFlight]() { return InFlight < maxInFlight; });
+
+					FullNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - waitStart).count();
+				}
+
+				++InFlight;
+			}
+
+			getThreadPool().Queue([this, task = std::move(task)]()
+			{
+				task();
+
+				std::lock_guard<std::mutex> guard(Lock);
+
+				--InFlight;
+
+				Finished.notify_all();
+			});
+		}
+
+		void Wait()
+		{
+			std::unique_lock<std::mutex> guard(Lock);
+
+			Finished.wait(guard, [this]() { return InFlight == 0; });
+		}
+
+		long long GetFullNanoseconds() const { return FullNanoseconds; }
+
+	private:
+		std::mutex Lock;
+		std::condition_variable Finished;
+		int InFlight = 0;
+		std::atomic<long long> FullNanoseconds = 0;
+	};
+
+	PendingDocuments pendingDocuments;
+
+	void writeLayout(const fs::path& outputPath, const GraphPackKey& key, const std::string& text)
+	{
+		GraphText graph;
+
+		if (!graph.Parse(text))
+			return;
+
+		GraphLayout layout;
+
+		layout.Settings = outputSettings.Layout;
+		layout.Build(graph);
+		layout.Layout();
+
+		fs::path svgPath = outputPath;
+		svgPath += ".svg";
+
+		std::stringstream svgText;
+
+		layout.WriteSvg(svgText);
+
+		getOutputWriter().Write(svgPath, svgText.str(), key);
+	}
+
+	// outputPath has no extension, the output format picks it.
+	void writeDocument(const fs::path& outputPath, const GraphPackKey& key, std::string text)
+	{
+		if (outputSettings.Format == GraphOutputFormat::Svg)
+		{
+			pendingDocuments.Queue([outputPath, key, text = std::move(text)]()
+			{
+				writeLayout(outputPath, key, text);
+			});
+
+			return;
+		}
+
+		fs::path digraphPath = outputPath;
+		digraphPath += ".digraph";
+
+		if (outputSettings.CompressionLevel <= 0)
+		{
+			getOutputWriter().Write(digraphPath, std::move(text), key);
+
+			return;
+		}
+
+		// compressed on the pool so it runs alongside generating the next graph
+		pendingDocuments.Queue([digraphPath, key, text = std::move(text)]() mutable
+		{
+			std::string compressed;
+
+			gzipText(text, outputSettings.CompressionLevel, compressed);
+
+			digraphPath += ".gz";
+
+			getOutputWriter().WriteGzip(digraphPath, std::move(compressed), text.size(), key);
+		});
+	}
+
+	void writeStatements(std::ostream& out, const GraphText& graph, const std::vector<int>& statements, const char* indent)
+	{
+		for (int index : statements)
+			out << indent << graph.Statements[index].Text << "\n";
+	}
+
+	void writeParts(const fs::path& outputRoot, const std::string& fileName, const std::string& rootName, const GraphPackKey& key, const GraphText& graph, const GraphPartitioning& partitioning)
+	{
+		fs::path partRoot = outputRoot;
+		partRoot += fileName;
+
+		for (int i = 0; i < (int)partitioning.Parts.size(); ++i)
+		{
+			const GraphPart& part = partitioning.Parts[i];
+
+			std::stringstream partText;
+
+			partText << "digraph " << graph.Name << "_" << (i + 1) << " {\n";
+
+			writeStatements(partText, graph, partitioning.RootStatements, "\t");
+			writeStatements(partText, graph, part.Statements, "\t");
+
+			partText << "}" << std::endl;
+
+			GraphPackKey partKey = key;
+
+			partKey.Part = (uint32_t)(i + 1);
+
+			writeDocument(partRoot / ("part_" + std::to_string(i + 1)), partKey, partText.str());
+		}
+
+		std::stringstream indexText;
+
+		indexText << "digraph " << graph.Name << "_Index {\n";
+
+		writeStatements(indexText, graph, partitioning.RootStatements, "\t");
+
+		for (int i = 0; i < (int)partitioning.Parts.size(); ++i)
+		{
+			const GraphPart& part = partitioning.Parts[i];
+
+			indexText << "\tpart_" << (i + 1) << " [label=\"Part " << (i + 1) << "\\n" << part.Nodes.size() << " Nodes\" shape=folder URL=\"" << fileName << "/part_" << (i + 1) << ".svg\"]\n";
+			indexText << "\t" << rootName << " -> part_" << (i + 1) << "\n";
+		}
+
+		indexText << "}" << std::endl;
+
+		fs::path indexPath = outputRoot;
+		indexPath += fileName;
+
+		writeDocument(indexPath, key, indexText.str());
+	}
+
+	void writeClusters(std::ostream& out, const GraphText& graph, const GraphPartitioning& partitioning)
+	{
+		out << "digraph " << graph.Name << " {\n";
+
+		writeStatements(out, graph, partitioning.RootStatements, "\t");
+
+		for (int i = 0; i < (int)partitioning.Parts.size(); ++i)
+		{
+			out << "\tsubgraph cluster_" << (i + 1) << " {\n";
+			out << "\t\tlabel=\"Part " << (i + 1) << "\"\n";
+
+			writeStatements(out, graph, partitioning.Parts[i].Statements, "\t\t");
+
+			out << "\t}\n";
+		}
+
+		out << "}" << std::endl;
+	}
+}
+
+void writeGraph(const fs::path& outputRoot, const std::string& fileName, const std::string& rootName, const GraphPackKey& key, std::string graphText)
+{
+	fs::path outputPath = outputRoot;
+	outputPath += fileName;
+
+	// the built in layout does not draw clusters, so clustered svg output falls back to the whole graph
+	bool writeClustered = outputSettings.SplitMode == GraphSplitMode::Clusters && outputSettings.Format != GraphOutputFormat::Svg;
+
+	if (outputSettings.SplitMode == GraphSplitMode::Files || writeClustered)
+	{
+		GraphText graph;
+
+		if (graph.Parse(graphText))
+		{
+			GraphPartitioning partitioning;
+
+			partitioning.Partition(graph, rootName, outputSettings.MaxPartNodes);
+
+			if (outputSettings.SplitMode == GraphSplitMode::Files && partitioning.Parts.size() > 1)
+			{
+				writeParts(outputRoot, fileName, rootName, key, graph, partitioning);
+
+				return;
+			}
+
+			if (writeClustered)
+			{
+				std::stringstream clusteredText;
+
+				writeClusters(clusteredText, graph, partitioning);
+
+				writeDocument(outputPath, key, clusteredText.str());
+
+				return;
+			}
+		}
+	}
+
+	writeDocument(outputPath, key, std::move(graphText));
+}
+
+void waitForGraphWrites()
+{
+	pendingDocuments.Wait();
+	getOutputWriter().Wait();
+}
+
+void printGraphWriteStats(std::ostream& out)
+{
+	OutputWriter& writer = getOutputWriter();
+
+	out << "output: " << writer.GetFilesWritten() << " files, " << writer.GetBytesWritten() << " bytes written, " << writer.GetQueueFullNanoseconds() / 1000000 << " ms waiting on a full write queue, " << pendingDocuments.GetFullNanoseconds() / 1000000 << " ms on layouts and compression" << std::endl;
+
+	if (writer.GetFilesFailed() > 0)
+		out << "output: " << writer.GetFilesFailed() << " files couldn't be written" << std::endl;
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <filesystem>
+#include <ostream>
+#include <string>
+
+#include "GraphLayout.h"
+#include "GraphPack.h"
+
+namespace fs = std::filesystem;
+
+enum class GraphSplitMode
+{
+	None,
+	Files,
+	Clusters
+};
+
+enum class GraphOutputFormat
+{
+	Digraph,
+	Svg
+};
+
+struct GraphOutputSettings
+{
+	GraphOutputFormat Format = GraphOutputFormat::Digraph;
+	GraphSplitMode SplitMode = GraphSplitMode::None;
+	int MaxPartNodes = 0;
+	GraphLayout::LayoutSettings Layout;
+
+	// descriptions go to tooltips.bin and nodes carry an id to look them up instead of an inline tooltip
+	bool SidecarTooltips = false;
+
+	// gzip level for .digraph output and the export, 0 writes plain text
+	int CompressionLevel = 0;
+
+	// finished files waiting on the writer thread before generating blocks, and layouts or compressions in flight
+	int WriteQueueLength = 64;
+};
+
+extern GraphOutputSettings outputSettings;
+
+// Svg output is laid out and compressed output is gzipped on the thread pool, at most WriteQueueLength graphs at a time,
+// and every file is written by the output writer; waitForGraphWrites blocks until every queued graph has been written.
+void writeGraph(const fs::path& outputRoot, const std::string& fileName, const std::string& rootName, const GraphPackKey& key, std::string graphText);
+void waitForGraphWrites();
+void printGraphWriteStats(std::ostream& out);
\ No newline at end of file
@@ -0,0 +1,26 @@
+#include "IngestStats.h"
+
+IngestStats ingestStats;
+
+namespace
+{
+	long long milliseconds(long long nanoseconds)
+	{
+		return nanoseconds / 1000000;
+	}
+}
+
+void printIngestStats(std::ostream& out)
+{
+	out << "items: " << ingestStats.ParsedItemFiles << " files parsed, " << ingestStats.SkippedItemFiles << " skipped by id (" << ingestStats.SkippedItemBytes << " bytes), " << ingestStats.SkippedItemEnvironments << " environments gated off" << std::endl;
+	out << "skills and effects: " << ingestStats.EarlyRejectedFiles << " files gated off before parsing" << std::endl;
+
+	if (ingestStats.VerifiedFiles > 0)
+		out << "parser check: " << ingestStats.VerifiedFiles << " files compared, " << ingestStats.MismatchedFiles << " mismatched" << std::endl;
+
+	for (const PrefetchStageStats& stage : ingestStats.PrefetchStages)
+	{
+		out << "prefetch " << stage.Name << ": " << stage.Files << " files, " << stage.Bytes << " bytes; io " << milliseconds(stage.ReadNanoseconds) << " ms reading, " << milliseconds(stage.RingFullNanoseconds) << " ms stalled on a full ring; ";
+		out << "parse " << milliseconds(stage.ParseNanoseconds) << " ms parsing, " << milliseconds(stage.ReadWaitNanoseconds) << " ms waiting on reads" << std::endl;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <atomic>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Time one prefetched table root spent on each side of the buffer ring. Read time is summed over the reader threads.
+struct PrefetchStageStats
+{
+	std::string Name;
+	int Files = 0;
+	long long Bytes = 0;
+	long long ReadNanoseconds = 0;
+	long long RingFullNanoseconds = 0;
+	long long ReadWaitNanoseconds = 0;
+	long long ParseNanoseconds = 0;
+};
+
+// Counters for work the loaders avoided, printed once loading finishes.
+struct IngestStats
+{
+	std::atomic<int> ParsedItemFiles = 0;
+	std::atomic<int> SkippedItemFiles = 0;
+	std::atomic<long long> SkippedItemBytes = 0;
+	std::atomic<int> SkippedItemEnvironments = 0;
+	std::atomic<int> EarlyRejectedFiles = 0;
+	std::atomic<int> VerifiedFiles = 0;
+	std::atomic<int> MismatchedFiles = 0;
+
+	// filled in by the loading thread as each stage finishes
+	std::vector<PrefetchStageStats> PrefetchStages;
+};
+
+extern IngestStats ingestStats;
+
+void printIngestStats(std::ostream& out);
\ No newline at end of file
@@ -0,0 +1,135 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const fs::path& filePath)
+{
+	Close();
+
+	HANDLE file = CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER fileSize;
+
+	if (!GetFileSizeEx(file, &fileSize))
+	{
+		CloseHandle(file);
+
+		return false;
+	}
+
+	FileHandle = file;
+
+	if (fileSize.QuadPart == 0)
+		return true;
+
+	MappingHandle = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+	if (MappingHandle == nullptr)
+	{
+		Close();
+
+		return false;
+	}
+
+	Data = (const char*)MapViewOfFile(MappingHandle, FILE_MAP_READ, 0, 0, 0);
+
+	if (Data == nullptr)
+	{
+		Close();
+
+		return false;
+	}
+
+	Size = (size_t)fileSize.QuadPart;
+
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (Data != nullptr)
+		UnmapViewOfFile(Data);
+
+	if (MappingHandle != nullptr)
+		CloseHandle(MappingHandle);
+
+	if (FileHandle != nullptr)
+		CloseHandle(FileHandle);
+
+	Data = nullptr;
+	Size = 0;
+	MappingHandle = nullptr;
+	FileHandle = nullptr;
+}
+
+#else
+
+bool MappedFile::Open(const fs::path& filePath)
+{
+	Close();
+
+	int file = open(filePath.c_str(), O_RDONLY);
+
+	if (file == -1)
+		return false;
+
+	struct stat status;
+
+	if (fstat(file, &status) != 0)
+	{
+		close(file);
+
+		return false;
+	}
+
+	if (status.st_size > 0)
+	{
+		void* data = mmap(nullptr, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+		if (data == MAP_FAILED)
+		{
+			close(file);
+
+			return false;
+		}
+
+		madvise(data, (size_t)status.st_size, MADV_SEQUENTIAL);
+
+		Data = (const char*)data;
+		Size = (size_t)status.st_size;
+	}
+
+	close(file);
+
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (Data != nullptr)
+		munmap((void*)Data, Size);
+
+	Data = nullptr;
+	Size = 0;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <filesystem>
+#include <string_view>
+
+namespace fs = std::filesystem;
+
+// Read only view of a whole file, memory mapped so large tables are paged in on demand instead of copied.
+class MappedFile
+{
+public:
+	MappedFile() {}
+	MappedFile(const MappedFile&) = delete;
+	~MappedFile();
+
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool Open(const fs::path& filePath);
+	void Close();
+
+	std::string_view GetText() const { return std::string_view(Data, Size); }
+
+private:
+	const char* Data = nullptr;
+	size_t Size = 0;
+
+#ifdef _WIN32
+	void* FileHandle = nullptr;
+	void* MappingHandle = nullptr;
+#endif
+};
\ No newline at end of file
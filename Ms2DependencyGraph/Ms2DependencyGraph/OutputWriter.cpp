@@ -0,0 +1,165 @@
+#include "OutputWriter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+
+#include "GraphWriting.h"
+
+OutputWriter::OutputWriter(int maxQueued) : MaxQueued(std::max(1, maxQueued))
+{
+	Thread = std::thread(&OutputWriter::Run, this);
+}
+
+OutputWriter::~OutputWriter()
+{
+	{
+		std::lock_guard<std::mutex> guard(Lock);
+
+		ShuttingDown = true;
+	}
+
+	FileQueued.notify_all();
+
+	Thread.join();
+}
+
+void OutputWriter::Write(fs::path filePath, std::string text, const GraphPackKey& key)
+{
+	uint64_t size = text.size();
+
+	Push(PendingFile{ std::move(filePath), std::move(text), key, GraphPackMethod::Stored, size });
+}
+
+void OutputWriter::WriteGzip(fs::path filePath, std::string data, uint64_t size, const GraphPackKey& key)
+{
+	Push(PendingFile{ std::move(filePath), std::move(data), key, GraphPackMethod::Gzip, size });
+}
+
+void OutputWriter::Push(PendingFile file)
+{
+	{
+		std::unique_lock<std::mutex> guard(Lock);
+
+		if ((int)Queue.size() >= MaxQueued)
+		{
+			std::chrono::steady_clock::time_point waitStart = std::chrono::steady_clock::now();
+
+			FileTaken.wait(guard, [this]() { return (int)Queue.size() < MaxQueued; });
+
+			QueueFullNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - waitStart).count();
+		}
+
+		Queue.push_back(std::move(file));
+	}
+
+	FileQueued.notify_one();
+}
+
+void OutputWriter::Wait()
+{
+	std::unique_lock<std::mutex> guard(Lock);
+
+	FilesFinished.wait(guard, [this]() { return Queue.size() == 0 && !Writing; });
+}
+
+bool OutputWriter::OpenPack(const fs::path& packPath, const fs::path& outputRoot)
+{
+	Wait();
+
+	std::lock_guard<std::mutex> guard(Lock);
+
+	return Pack.Open(packPath, outputRoot);
+}
+
+bool OutputWriter::ClosePack()
+{
+	Wait();
+
+	std::lock_guard<std::mutex> guard(Lock);
+
+	return Pack.Close();
+}
+
+void OutputWriter::Run()
+{
+	while (true)
+	{
+		PendingFile file;
+
+		{
+			std::unique_lock<std::mutex> guard(Lock);
+
+			FileQueued.wait(guard, [this]() { return ShuttingDown || Queue.size() > 0; });
+
+			if (Queue.size() == 0)
+				return;
+
+			file = std::move(Queue.front());
+			Queue.pop_front();
+
+			Writing = true;
+		}
+
+		FileTaken.notify_all();
+
+		WriteFile(file);
+
+		{
+			std::lock_guard<std::mutex> guard(Lock);
+
+			Writing = false;
+
+			if (Queue.size() == 0)
+				FilesFinished.notify_all();
+		}
+	}
+}
+
+void OutputWriter::WriteFile(const PendingFile& file)
+{
+	if (Pack.IsOpen())
+	{
+		if (!Pack.Append(file.Key, file.FilePath, file.Data, file.Method, file.Size))
+		{
+			++FilesFailed;
+
+			return;
+		}
+
+		++FilesWritten;
+		BytesWritten += (long long)file.Data.size();
+
+		return;
+	}
+
+	fs::path directory = file.FilePath.parent_path();
+
+	std::error_code error;
+
+	// this runs on the writer thread, where a throw would end the program, and a directory that couldn't be made is
+	// tried again by the next file in it
+	if (CreatedDirectories.insert(directory.string()).second && !fs::create_directories(directory, error) && error)
+		CreatedDirectories.erase(directory.string());
+
+	std::ofstream outFile(file.FilePath, file.Method == GraphPackMethod::Stored ? std::ofstream::out : std::ofstream::out | std::ofstream::binary);
+
+	outFile << file.Data;
+
+	if (!outFile)
+	{
+		++FilesFailed;
+
+		return;
+	}
+
+	++FilesWritten;
+	BytesWritten += (long long)file.Data.size();
+}
+
+OutputWriter& getOutputWriter()
+{
+	static OutputWriter writer(outputSettings.WriteQueueLength);
+
+	return writer;
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+
+#include "GraphPack.h"
+
+namespace fs = std::filesystem;
+
+// Writes finished output files on its own thread so generating the next graph overlaps with creating and filling the
+// last one. Write blocks while MaxQueued files are already waiting. With a pack open the files are appended to it instead,
+// under the key they were written with.
+class OutputWriter
+{
+public:
+	OutputWriter(int maxQueued);
+	~OutputWriter();
+
+	void Write(fs::path filePath, std::string text, const GraphPackKey& key);
+
+	// a gzip member of size bytes of text, kept compressed in a pack too
+	void WriteGzip(fs::path filePath, std::string data, uint64_t size, const GraphPackKey& key);
+	void Wait();
+
+	// Called while no writes are queued. Paths in the pack are relative to outputRoot.
+	bool OpenPack(const fs::path& packPath, const fs::path& outputRoot);
+	bool ClosePack();
+
+	int GetFilesWritten() const { return FilesWritten; }
+	int GetFilesFailed() const { return FilesFailed; }
+	long long GetBytesWritten() const { return BytesWritten; }
+	long long GetQueueFullNanoseconds() const { return QueueFullNanoseconds; }
+
+private:
+	struct PendingFile
+	{
+		fs::path FilePath;
+		std::string Data;
+		GraphPackKey Key;
+		GraphPackMethod Method = GraphPackMethod::Stored;
+		uint64_t Size = 0;
+	};
+
+	std::mutex Lock;
+	std::condition_variable FileQueued;
+	std::condition_variable FileTaken;
+	std::condition_variable FilesFinished;
+	std::deque<PendingFile> Queue;
+	std::thread Thread;
+	int MaxQueued = 1;
+	bool Writing = false;
+	bool ShuttingDown = false;
+
+	// only opened and closed while the queue is idle
+	GraphPackWriter Pack;
+
+	// only touched by the writer thread
+	std::unordered_set<std::string> CreatedDirectories;
+
+	std::atomic<int> FilesWritten = 0;
+	std::atomic<int> FilesFailed = 0;
+	std::atomic<long long> BytesWritten = 0;
+	std::atomic<long long> QueueFullNanoseconds = 0;
+
+	void Push(PendingFile file);
+	void Run();
+	void WriteFile(const PendingFile& file);
+};
+
+// The writer is started on first use with outputSettings.WriteQueueLength.
+OutputWriter& getOutputWriter();
\ No newline at end of file
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "ParserUtils.h"
+
+// FNV-1a over an element or attribute name. Names are matched by hash first, so the per attribute cost is one hash
+// instead of a strcmp against every name a parser knows.
+constexpr uint64_t schemaHash(std::string_view name)
+{
+	uint64_t hash = 14695981039346656037ull;
+
+	for (char character : name)
+	{
+		hash ^= (unsigned char)character;
+		hash *= 1099511628211ull;
+	}
+
+	return hash;
+}
+
+// Compile time only version, for the name side of element name checks.
+consteval uint64_t schemaName(std::string_view name)
+{
+	return schemaHash(name);
+}
+
+template <typename Object, typename Type>
+struct SchemaField
+{
+	const char* Name = nullptr;
+	uint64_t Hash = 0;
+	Type Object::* Member = nullptr;
+	Type Default = Type();
+
+	Type& Get(Object& object) const { return object.*Member; }
+};
+
+template <typename Object, typename Outer, typename Type>
+struct NestedSchemaField
+{
+	const char* Name = nullptr;
+	uint64_t Hash = 0;
+	Outer Object::* OuterMember = nullptr;
+	Type Outer::* Member = nullptr;
+	Type Default = Type();
+
+	Type& Get(Object& object) const { return (object.*OuterMember).*Member; }
+};
+
+// Maps an attribute to a member. Missing attributes set the default, vector members read a comma separated list and
+// are appended to like readAttribute does, so they keep what they had when the attribute is missing.
+template <typename Object, typename Type>
+constexpr SchemaField<Object, Type> schemaField(const char* name, Type Object::* member, std::type_identity_t<Type> defaultValue = Type())
+{
+	return SchemaField<Object, Type>{ name, schemaHash(name), member, defaultValue };
+}
+
+template <typename Object, typename Outer, typename Type>
+constexpr NestedSchemaField<Object, Outer, Type> schemaField(const char* name, Outer Object::* outerMember, Type Outer::* member, std::type_identity_t<Type> defaultValue = Type())
+{
+	return NestedSchemaField<Object, Outer, Type>{ name, schemaHash(name), outerMember, member, defaultValue };
+}
+
+template <typename... Fields>
+constexpr std::tuple<Fields...> schema(Fields... fields)
+{
+	return std::tuple<Fields...>(fields...);
+}
+
+namespace schemaDetail
+{
+	template <typename Type>
+	struct IsVector : std::false_type {};
+
+	template <typename Type>
+	struct IsVector<std::vector<Type>> : std::true_type {};
+
+	template <typename Callback>
+	void forEachAttribute(tinyxml2::XMLElement* node, const Callback& callback)
+	{
+		for (const tinyxml2::XMLAttribute* attribute = node->FirstAttribute(); attribute; attribute = attribute->Next())
+			callback(attribute->Name(), attribute->Value());
+	}
+
+	template <typename Callback>
+	void forEachAttribute(const XmlSpanElement* node, const Callback& callback)
+	{
+		for (int i = 0; i < node->AttributeCount; ++i)
+		{
+			const XmlSpanAttribute& attribute = node->GetAttribute(i);
+
+			callback(attribute.Name, attribute.Value);
+		}
+	}
+
+	template <typename Callback>
+	void forEachAttribute(const XmlStreamElement& node, const Callback& callback)
+	{
+		for (const XmlStreamAttribute& attribute : node.Attributes)
+			callback(node.Text.c_str() + attribute.Name, node.Text.c_str() + attribute.Value);
+	}
+
+	template <typename Object, typename Field>
+	void resetField(Object& object, const Field& field)
+	{
+		using Type = std::remove_reference_t<decltype(field.Get(object))>;
+
+		if constexpr (!IsVector<Type>::value)
+			field.Get(object) = field.Default;
+	}
+
+	template <typename Object, typename Field>
+	void readField(Object& object, const Field& field, uint64_t hash, const char* name, const char* value)
+	{
+		if (hash != field.Hash || strcmp(name, field.Name) != 0)
+			return;
+
+		using Type = std::remove_reference_t<decltype(field.Get(object))>;
+
+		if constexpr (IsVector<Type>::value)
+			readValues(value, field.Get(object));
+		else
+			field.Get(object) = readTinyxml2Value<Type>(value);
+	}
+}
+
+// Reads every field of a schema from one element in a single pass over its attributes. Works on tinyxml2, in situ and
+// streamed elements, with tinyxml2's value conversions on all of them.
+template <typename Node, typename Object, typename... Fields>
+void readSchema(const Node& node, Object& object, const std::tuple<Fields...>& fields)
+{
+	std::apply([&object](const Fields&... field)
+	{
+		(schemaDetail::resetField(object, field), ...);
+	}, fields);
+
+	schemaDetail::forEachAttribute(node, [&object, &fields](const char* name, const char* value)
+	{
+		uint64_t hash = schemaHash(name);
+
+		std::apply([&object, hash, name, value](const Fields&... field)
+		{
+			(schemaDetail::readField(object, field, hash, name, value), ...);
+		}, fields);
+	});
+}
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "ParserUtils.h"
 
+#include "XmlSource.h"
+
 std::unordered_map<std::string, int> features;
 std::string locale;
 
@@ -111,65 +113,134 @@ SupportLevel matchesLocale(const char* nodeLocale)
 	return locale == nodeLocale ? SupportLevel::Override : SupportLevel::None;
 }
 
-SupportSettings featureIsActive(tinyxml2::XMLElement* node, SupportSettings& settings)
+namespace
 {
-	const tinyxml2::XMLAttribute* attribute = node->FindAttribute("feature");
+	const char* findAttributeValue(tinyxml2::XMLElement* node, const char* name)
+	{
+		const tinyxml2::XMLAttribute* attribute = node->FindAttribute(name);
 
-	int support = -1;
-	const char* feature = "";
+		return attribute != nullptr ? attribute->Value() : nullptr;
+	}
 
-	if (attribute != nullptr)
+	const char* findAttributeValue(const XmlStreamElement& node, const char* name)
 	{
-		feature = attribute->Value();
-		support = featureIsActive(feature);
+		return node.FindAttribute(name);
 	}
 
-	if (settings.OverriddenBy(support))
-		return SupportSettings{ feature, SupportLevel::Default, support };
+	const char* findAttributeValue(const XmlSpanElement* node, const char* name)
+	{
+		return node->FindAttribute(name);
+	}
 
-	return SupportSettings{ "", SupportLevel::None };
-}
+	template <typename Node>
+	SupportSettings readFeature(const Node& node, SupportSettings& settings)
+	{
+		const char* attribute = findAttributeValue(node, "feature");
 
-SupportSettings matchesLocale(tinyxml2::XMLElement* node, SupportSettings& settings)
-{
-	const tinyxml2::XMLAttribute* attribute = node->FindAttribute("locale");
+		int support = -1;
+		const char* feature = "";
+
+		if (attribute != nullptr)
+		{
+			feature = attribute;
+			support = featureIsActive(feature);
+		}
 
-	SupportLevel support = SupportLevel::Default;
-	const char* locale = "";
+		if (settings.OverriddenBy(support))
+			return SupportSettings{ feature, SupportLevel::Default, support };
 
-	if (attribute != nullptr)
+		return SupportSettings{ "", SupportLevel::None };
+	}
+
+	template <typename Node>
+	SupportSettings readLocale(const Node& node, SupportSettings& settings)
 	{
-		locale = attribute->Value();
-		support = matchesLocale(locale);
+		const char* attribute = findAttributeValue(node, "locale");
+
+		SupportLevel support = SupportLevel::Default;
+		const char* locale = "";
+
+		if (attribute != nullptr)
+		{
+			locale = attribute;
+			support = matchesLocale(locale);
+		}
+
+		if (settings.OverriddenBy(support))
+			return SupportSettings{ locale, support };
+
+		return SupportSettings{ "", SupportLevel::None };
 	}
 
-	if (settings.OverriddenBy(support))
-		return SupportSettings{ locale, support };
+	template <typename Node>
+	bool readNodeEnabled(const Node& node, SupportSettings* feature, SupportSettings* locale)
+	{
+		SupportSettings featureFound;
+		SupportSettings localeFound;
+
+		if (feature != nullptr)
+			featureFound = readFeature(node, *feature);
+
+		if (locale != nullptr)
+			localeFound = readLocale(node, *locale);
+
+		if (featureFound.Version == -1 || featureFound.Version == 99 || featureFound.Version < feature->Version || localeFound.Level == SupportLevel::None)
+			return false;
+
+		if (feature != nullptr)
+			*feature = featureFound;
 
-	return SupportSettings{ "", SupportLevel::None };
+		if (locale != nullptr)
+			*locale = localeFound;
+
+		return true;
+	}
+}
+
+SupportSettings featureIsActive(tinyxml2::XMLElement* node, SupportSettings& settings)
+{
+	return readFeature(node, settings);
+}
+
+SupportSettings matchesLocale(tinyxml2::XMLElement* node, SupportSettings& settings)
+{
+	return readLocale(node, settings);
 }
 
 bool isNodeEnabled(tinyxml2::XMLElement* node, SupportSettings* feature, SupportSettings* locale)
 {
-	SupportSettings featureFound;
-	SupportSettings localeFound;
+	return readNodeEnabled(node, feature, locale);
+}
 
-	if (feature != nullptr)
-		featureFound = featureIsActive(node, *feature);
+bool isNodeEnabled(const XmlStreamElement& node, SupportSettings* feature, SupportSettings* locale)
+{
+	return readNodeEnabled(node, feature, locale);
+}
 
-	if (locale != nullptr)
-		localeFound = matchesLocale(node, *locale);
+bool isNodeEnabled(const XmlSpanElement* node, SupportSettings* feature, SupportSettings* locale)
+{
+	return readNodeEnabled(node, feature, locale);
+}
 
-	if (featureFound.Version == -1 || featureFound.Version == 99 || featureFound.Version < feature->Version || localeFound.Level == SupportLevel::None)
-		return false;
+tinyxml2::XMLDocument& getThreadDocument()
+{
+	thread_local tinyxml2::XMLDocument document(true, tinyxml2::PRESERVE_WHITESPACE);
 
-	if (feature != nullptr)
-		*feature = featureFound;
+	document.Clear();
 
-	if (locale != nullptr)
-		*locale = localeFound;
+	return document;
+}
 
-	return true;
+bool isRootEnabled(std::string_view text, SupportSettings* feature, SupportSettings* locale)
+{
+	XmlStreamReader reader;
+
+	reader.Open(text);
+
+	if (!reader.NextElement())
+		return false;
+
+	return readNodeEnabled(reader.GetElement(), feature, locale);
 }
 
 bool loadFeatures(const fs::path& tableRoot, const char* locale, const char* env)
@@ -180,7 +251,10 @@ bool loadFeatures(const fs::path& tableRoot, const char* locale, const char* env
 	fs::path featurePath = tableRoot;
 	featurePath += "feature.xml";
 
-	if (!fs::exists(featurePath) || !fs::exists(featureSettingPath))
+	XmlSourceFile featureFile;
+	XmlSourceFile featureSettingFile;
+
+	if (!featureFile.Open(featurePath) || !featureSettingFile.Open(featureSettingPath))
 		return false;
 
 	int featureLevel = -1;
@@ -188,7 +262,7 @@ bool loadFeatures(const fs::path& tableRoot, const char* locale, const char* env
 	{
 		tinyxml2::XMLDocument document;
 
-		document.LoadFile(featureSettingPath.string().c_str());
+		document.Parse(featureSettingFile.GetText().data(), featureSettingFile.GetText().size());
 
 		tinyxml2::XMLElement* rootElement = document.RootElement();
 
@@ -213,7 +287,7 @@ bool loadFeatures(const fs::path& tableRoot, const char* locale, const char* env
 
 	tinyxml2::XMLDocument document;
 
-	document.LoadFile(featurePath.string().c_str());
+	document.Parse(featureFile.GetText().data(), featureFile.GetText().size());
 
 	tinyxml2::XMLElement* rootElement = document.RootElement();
 
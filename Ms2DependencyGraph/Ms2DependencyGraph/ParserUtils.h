@@ -3,9 +3,12 @@
 #include <unordered_map>
 #include <string>
 #include <filesystem>
+#include <type_traits>
 #include <vector>
 
 #include "tinyxml2.h"
+#include "XmlStreamReader.h"
+#include "XmlSpanDocument.h"
 
 namespace fs = std::filesystem;
 
@@ -50,6 +53,8 @@ struct SupportSettings
 	{
 		return version >= 0 && version > Version && version != 99;
 	}
+
+	bool operator==(const SupportSettings&) const = default;
 };
 
 extern std::unordered_map<std::string, int> features;
@@ -65,6 +70,17 @@ SupportSettings matchesLocale(tinyxml2::XMLElement* node, SupportSettings& setti
 
 bool isNodeEnabled(tinyxml2::XMLElement* node, SupportSettings* feature, SupportSettings* locale);
 
+bool isNodeEnabled(const XmlStreamElement& node, SupportSettings* feature, SupportSettings* locale);
+
+bool isNodeEnabled(const XmlSpanElement* node, SupportSettings* feature, SupportSettings* locale);
+
+// Document owned by the calling thread, cleared rather than destroyed between files so its node pools stay allocated.
+// Only one caller per thread may hold it at a time.
+tinyxml2::XMLDocument& getThreadDocument();
+
+// Checks only the root start tag of a document, so gated off files can be dropped before a DOM is built.
+bool isRootEnabled(std::string_view text, SupportSettings* feature, SupportSettings* locale);
+
 template <typename Type>
 Type readValue(const tinyxml2::XMLAttribute* attribute);
 
@@ -131,15 +147,68 @@ template <>
 unsigned long long readValue<unsigned long long>(const char* value);
 
 template <typename Type>
-void readAttribute(tinyxml2::XMLElement* node, const char* name, std::vector<Type>& vector)
+Type readAttribute(const XmlStreamElement& node, const char* name, const Type& defaultValue)
 {
-	const tinyxml2::XMLAttribute* attribute = node->FindAttribute(name);
+	const char* value = node.FindAttribute(name);
 
-	if (attribute == nullptr)
-		return;
+	if (value == nullptr)
+		return defaultValue;
+
+	return readValue<Type>(value);
+}
+
+// Same conversions as the tinyxml2 readValue specializations, so both DOM parsers read identical models.
+template <typename Type>
+Type readTinyxml2Value(const char* value)
+{
+	if constexpr (std::is_same_v<Type, float>)
+	{
+		float result = 0;
+
+		tinyxml2::XMLUtil::ToFloat(value, &result);
+
+		return result;
+	}
+	else if constexpr (std::is_same_v<Type, double>)
+	{
+		double result = 0;
+
+		tinyxml2::XMLUtil::ToDouble(value, &result);
+
+		return result;
+	}
+	else if constexpr (sizeof(Type) == sizeof(int64_t))
+	{
+		int64_t result = 0;
+
+		tinyxml2::XMLUtil::ToInt64(value, &result);
+
+		return (Type)result;
+	}
+	else
+	{
+		int result = 0;
+
+		tinyxml2::XMLUtil::ToInt(value, &result);
+
+		return (Type)result;
+	}
+}
 
-	const char* value = attribute->Value();
+template <typename Type>
+Type readAttribute(const XmlSpanElement* node, const char* name, const Type& defaultValue)
+{
+	const char* value = node->FindAttribute(name);
+
+	if (value == nullptr)
+		return defaultValue;
 
+	return readTinyxml2Value<Type>(value);
+}
+
+template <typename Type>
+void readValues(const char* value, std::vector<Type>& vector)
+{
 	if (strcmp(value, "") == 0)
 		return;
 
@@ -157,4 +226,37 @@ void readAttribute(tinyxml2::XMLElement* node, const char* name, std::vector<Typ
 	}
 }
 
+template <typename Type>
+void readAttribute(tinyxml2::XMLElement* node, const char* name, std::vector<Type>& vector)
+{
+	const tinyxml2::XMLAttribute* attribute = node->FindAttribute(name);
+
+	if (attribute == nullptr)
+		return;
+
+	readValues(attribute->Value(), vector);
+}
+
+template <typename Type>
+void readAttribute(const XmlStreamElement& node, const char* name, std::vector<Type>& vector)
+{
+	const char* value = node.FindAttribute(name);
+
+	if (value == nullptr)
+		return;
+
+	readValues(value, vector);
+}
+
+template <typename Type>
+void readAttribute(const XmlSpanElement* node, const char* name, std::vector<Type>& vector)
+{
+	const char* value = node->FindAttribute(name);
+
+	if (value == nullptr)
+		return;
+
+	readValues(value, vector);
+}
+
 bool loadFeatures(const fs::path& tableRoot, const char* locale, const char* env);
\ No newline at end of file
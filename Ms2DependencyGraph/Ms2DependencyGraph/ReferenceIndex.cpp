@@ -0,0 +1,133 @@
+#include "ReferenceIndex.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+#include "XmlParsing.h"
+
+namespace
+{
+	bool nodeLess(const GraphNodeId& left, const GraphNodeId& right)
+	{
+		return getNodeKey(left) < getNodeKey(right);
+	}
+
+	void sortNodes(std::vector<GraphNodeId>& nodes)
+	{
+		std::sort(nodes.begin(), nodes.end(), nodeLess);
+
+		nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+	}
+
+	void insertNode(std::vector<GraphNodeId>& nodes, const GraphNodeId& node)
+	{
+		auto position = std::lower_bound(nodes.begin(), nodes.end(), node, nodeLess);
+
+		if (position == nodes.end() || !(*position == node))
+			nodes.insert(position, node);
+	}
+}
+
+uint64_t getNodeKey(const GraphNodeId& node)
+{
+	return ((uint64_t)node.Type << 32) | (uint32_t)node.Id;
+}
+
+void ReferenceIndex::Build()
+{
+	Referrers.clear();
+	Targets.clear();
+
+	forEachExportEdge([this](const GraphNodeId& from, const GraphNodeId& to) { Add(from, to); });
+
+	for (const std::pair<const JobCode, JobData>& job : model().Jobs)
+	{
+		GraphNodeId jobNode{ GraphNodeType::Job, (int)job.first };
+
+		for (const JobSkill& jobSkill : job.second.Skills)
+		{
+			Add(jobNode, GraphNodeId{ GraphNodeType::Skill, jobSkill.Skill.Id });
+
+			for (const ReferenceData& subSkill : jobSkill.SubSkills)
+				Add(jobNode, GraphNodeId{ GraphNodeType::Skill, subSkill.Id });
+		}
+
+		for (const ItemData* item : job.second.Lapenshards)
+			Add(jobNode, GraphNodeId{ GraphNodeType::Item, item->Id });
+	}
+
+	// a node can refer to the same one from several levels or triggers
+	for (auto& referrers : Referrers)
+		sortNodes(referrers.second);
+
+	for (auto& targets : Targets)
+		sortNodes(targets.second);
+}
+
+void ReferenceIndex::Update(const std::vector<GraphNodeId>& nodes)
+{
+	for (const GraphNodeId& node : nodes)
+	{
+		auto targets = Targets.find(getNodeKey(node));
+
+		if (targets == Targets.end())
+			continue;
+
+		for (const GraphNodeId& target : targets->second)
+		{
+			std::vector<GraphNodeId>& referrers = Referrers[getNodeKey(target)];
+			auto position = std::lower_bound(referrers.begin(), referrers.end(), node, nodeLess);
+
+			if (position != referrers.end() && *position == node)
+				referrers.erase(position);
+		}
+
+		Targets.erase(targets);
+	}
+
+	for (const GraphNodeId& node : nodes)
+		forEachExportEdge(node, [this](const GraphNodeId& from, const GraphNodeId& to) { Insert(from, to); });
+}
+
+const std::vector<GraphNodeId>& ReferenceIndex::GetReferrers(const GraphNodeId& node) const
+{
+	static const std::vector<GraphNodeId> none;
+
+	auto index = Referrers.find(getNodeKey(node));
+
+	return index == Referrers.end() ? none : index->second;
+}
+
+void ReferenceIndex::FindRoots(const std::vector<GraphNodeId>& nodes, std::vector<GraphNodeId>& roots) const
+{
+	std::unordered_set<uint64_t> visited;
+	std::vector<GraphNodeId> pending = nodes;
+
+	while (pending.size() > 0)
+	{
+		GraphNodeId node = pending.back();
+
+		pending.pop_back();
+
+		if (!visited.insert(getNodeKey(node)).second)
+			continue;
+
+		if (node.Type == GraphNodeType::Job || node.Type == GraphNodeType::SetBonus)
+			roots.push_back(node);
+
+		for (const GraphNodeId& referrer : GetReferrers(node))
+			pending.push_back(referrer);
+	}
+}
+
+void ReferenceIndex::Add(const GraphNodeId& from, const GraphNodeId& to)
+{
+	Referrers[getNodeKey(to)].push_back(from);
+	Targets[getNodeKey(from)].push_back(to);
+}
+
+void ReferenceIndex::Insert(const GraphNodeId& from, const GraphNodeId& to)
+{
+	insertNode(Referrers[getNodeKey(to)], from);
+	insertNode(Targets[getNodeKey(from)], to);
+}
\ No newline at end of file
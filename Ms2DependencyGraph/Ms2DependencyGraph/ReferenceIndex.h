@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "GraphExport.h"
+
+// Which nodes refer to each node: the export's edges turned around, plus the skills each job starts from.
+class ReferenceIndex
+{
+public:
+	// from model()
+	void Build();
+
+	// re-reads the edges out of nodes from model() after they were parsed again, or dropped
+	void Update(const std::vector<GraphNodeId>& nodes);
+
+	const std::vector<GraphNodeId>& GetReferrers(const GraphNodeId& node) const;
+
+	// the jobs and set bonuses that reach any of nodes, each once
+	void FindRoots(const std::vector<GraphNodeId>& nodes, std::vector<GraphNodeId>& roots) const;
+
+private:
+	std::unordered_map<uint64_t, std::vector<GraphNodeId>> Referrers;
+	std::unordered_map<uint64_t, std::vector<GraphNodeId>> Targets;
+
+	void Add(const GraphNodeId& from, const GraphNodeId& to);
+	void Insert(const GraphNodeId& from, const GraphNodeId& to);
+};
+
+uint64_t getNodeKey(const GraphNodeId& node);
\ No newline at end of file
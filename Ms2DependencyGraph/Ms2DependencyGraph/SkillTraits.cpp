@@ -0,0 +1,153 @@
+#include "SkillTraits.h"
+
+#include <vector>
+
+#include "XmlParsing.h"
+#include "ThreadPool.h"
+
+namespace
+{
+	struct TraitReferences
+	{
+		std::vector<int> SplashSkills;
+		std::vector<int> SensorSkills;
+	};
+
+	bool isProjectile(const SkillLevelData& skillLevel)
+	{
+		for (const SkillMotion& motion : skillLevel.Motions)
+		{
+			for (const SkillAttack& attack : motion.Attacks)
+			{
+				if (attack.MagicPathId == 0)
+					continue;
+
+				auto index = model().MagicPaths.find(attack.MagicPathId);
+
+				if (index == model().MagicPaths.end())
+					continue;
+
+				for (const MagicPathMove& move : index->second.Moves)
+					if (move.Velocity > 0)
+						return true;
+			}
+		}
+
+		return false;
+	}
+
+	void addSplashReferences(const ConditionSkill& trigger, TraitReferences& references)
+	{
+		if (!trigger.IsSplash)
+			return;
+
+		if (trigger.Reference.Type == ReferenceType::Skill)
+			references.SplashSkills.push_back(trigger.Reference.Id);
+
+		for (const ReferenceData& cast : trigger.RandomCasts)
+			if (cast.Type == ReferenceType::Skill)
+				references.SplashSkills.push_back(cast.Id);
+	}
+
+	template <typename Key, typename Value>
+	std::vector<Value*> getEntries(std::unordered_map<Key, Value>& map)
+	{
+		std::vector<Value*> entries;
+
+		entries.reserve(map.size());
+
+		for (auto& entry : map)
+			entries.push_back(&entry.second);
+
+		return entries;
+	}
+}
+
+void computeSkillTraits()
+{
+	std::vector<SkillData*> skillEntries = getEntries(model().Skills);
+	std::vector<AdditionalEffectData*> effectEntries = getEntries(model().Effects);
+
+	std::vector<TraitReferences> skillReferences(skillEntries.size());
+	std::vector<TraitReferences> effectReferences(effectEntries.size());
+
+	parallelFor((int)skillEntries.size(), [&skillEntries, &skillReferences](int start, int end)
+	{
+		for (int i = start; i < end; ++i)
+		{
+			SkillData& skill = *skillEntries[i];
+			TraitReferences& references = skillReferences[i];
+
+			skill.Traits = SkillTraits();
+
+			for (auto& level : skill.Levels)
+			{
+				SkillLevelData& skillLevel = level.second;
+
+				skillLevel.Traits = SkillTraits();
+				skillLevel.Traits.IsProjectile = isProjectile(skillLevel);
+
+				for (const ConditionSkill& passive : skillLevel.Passives)
+					addSplashReferences(passive, references);
+
+				for (const SkillMotion& motion : skillLevel.Motions)
+				{
+					for (const SkillAttack& attack : motion.Attacks)
+					{
+						for (const ConditionSkill& trigger : attack.Triggers)
+						{
+							addSplashReferences(trigger, references);
+
+							if (trigger.IsSplash && trigger.OnlySensingActive)
+								references.SensorSkills.push_back(trigger.Reference.Id);
+						}
+					}
+				}
+			}
+		}
+	});
+
+	parallelFor((int)effectEntries.size(), [&effectEntries, &effectReferences](int start, int end)
+	{
+		for (int i = start; i < end; ++i)
+			for (const auto& level : effectEntries[i]->Levels)
+				for (const ConditionSkill& trigger : level.second.Triggers)
+					addSplashReferences(trigger, effectReferences[i]);
+	});
+
+	// splash targets that were never loaded still get an entry so they print as missing splash skills
+	for (std::vector<TraitReferences>* referenceList : { &skillReferences, &effectReferences })
+	{
+		for (const TraitReferences& references : *referenceList)
+		{
+			for (int skillId : references.SplashSkills)
+				model().Skills[skillId].Traits.IsSplash = 1;
+
+			for (int skillId : references.SensorSkills)
+			{
+				auto skillIndex = model().Skills.find(skillId);
+
+				if (skillIndex != model().Skills.end())
+					skillIndex->second.Traits.IsSensor = 1;
+			}
+		}
+	}
+
+	skillEntries = getEntries(model().Skills);
+
+	parallelFor((int)skillEntries.size(), [&skillEntries](int start, int end)
+	{
+		for (int i = start; i < end; ++i)
+		{
+			SkillData& skill = *skillEntries[i];
+
+			for (auto& level : skill.Levels)
+			{
+				SkillTraits& traits = level.second.Traits;
+
+				traits.IsSensor = skill.Traits.IsSensor && !traits.IsProjectile;
+				traits.IsSplash = skill.Traits.IsSplash;
+			}
+		}
+	});
+}
\ No newline at end of file
@@ -0,0 +1,5 @@
+#pragma once
+
+// Fills SkillData::Traits and SkillLevelData::Traits from the whole loaded dataset. Splash and sensor flags come from
+// every trigger that targets a skill, so a node's label no longer depends on which graph reached it first.
+void computeSkillTraits();
\ No newline at end of file
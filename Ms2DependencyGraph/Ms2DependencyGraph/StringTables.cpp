@@ -0,0 +1,79 @@
+#include "StringTables.h"
+
+#include <algorithm>
+#include <string_view>
+
+#include "XmlParsing.h"
+#include "ThreadPool.h"
+#include "XmlSource.h"
+
+const std::vector<StringTableHandler> stringTableHandlers = {
+	{ "skillname", StringTableTarget::Skills, &ParseSkillNameStrings, true },
+	{ "korskilldescription", StringTableTarget::Skills, &ParseSkillDescriptionStrings, true },
+	{ "koradditionaldescription", StringTableTarget::Effects, &ParseEffectStrings, true },
+	{ "itemname", StringTableTarget::Items, &ParseItemStrings, false },
+	{ "koritemdescription", StringTableTarget::Items, &ParseItemDescriptionStrings, false },
+	{ "jobname", StringTableTarget::Jobs, &ParseJobStrings, false },
+	{ "setitemname", StringTableTarget::SetBonuses, &ParseSetBonusStrings, false }
+};
+
+namespace
+{
+	struct StringTableFile
+	{
+		const StringTableHandler* Handler = nullptr;
+		fs::path FilePath;
+	};
+
+	const StringTableHandler* findHandler(const fs::path& filePath, bool isTopLevel)
+	{
+		std::string stem = filePath.stem().string();
+
+		for (const StringTableHandler& handler : stringTableHandlers)
+		{
+			std::string_view name = handler.Name;
+
+			if (handler.MatchPrefix ? stem.starts_with(name) : isTopLevel && stem == name && filePath.extension() == ".xml")
+				return &handler;
+		}
+
+		return nullptr;
+	}
+}
+
+void loadStringTables(const fs::path& stringRoot)
+{
+	std::vector<std::vector<StringTableFile>> targets;
+
+	fs::path topLevel = stringRoot.parent_path();
+
+	forEachXmlFile(stringRoot, true, [&targets, &topLevel](const fs::path& filePath)
+	{
+		const StringTableHandler* handler = findHandler(filePath, filePath.parent_path() == topLevel);
+
+		if (handler == nullptr)
+			return;
+
+		size_t target = (size_t)handler->Target;
+
+		if (targets.size() <= target)
+			targets.resize(target + 1);
+
+		targets[target].push_back(StringTableFile{ handler, filePath });
+	});
+
+	// within a target, files load in handler order so e.g. item names still apply before item descriptions. Files of one
+	// handler load in path order, since the last one to set a string wins and directories list in no particular order
+	for (std::vector<StringTableFile>& files : targets)
+	{
+		std::sort(files.begin(), files.end(), [](const StringTableFile& left, const StringTableFile& right) { return left.FilePath < right.FilePath; });
+		std::stable_sort(files.begin(), files.end(), [](const StringTableFile& left, const StringTableFile& right) { return left.Handler < right.Handler; });
+	}
+
+	parallelFor((int)targets.size(), [&targets](int start, int end)
+	{
+		for (int i = start; i < end; ++i)
+			for (const StringTableFile& file : targets[i])
+				file.Handler->Parse(file.FilePath);
+	});
+}
\ No newline at end of file
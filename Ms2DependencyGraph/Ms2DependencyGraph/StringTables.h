@@ -0,0 +1,31 @@
+#pragma once
+
+#include <filesystem>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// Tables that write into the same records are loaded one after another, different targets load concurrently.
+enum class StringTableTarget
+{
+	Skills,
+	Effects,
+	Items,
+	Jobs,
+	SetBonuses
+};
+
+struct StringTableHandler
+{
+	const char* Name = "";
+	StringTableTarget Target = StringTableTarget::Skills;
+	void (*Parse)(const fs::path& filePath) = nullptr;
+
+	// prefix handlers take any file under the string directory whose name starts with Name, exact ones only Name.xml at the top
+	bool MatchPrefix = false;
+};
+
+extern const std::vector<StringTableHandler> stringTableHandlers;
+
+// Lists the string directory once and only opens the files a handler claims.
+void loadStringTables(const fs::path& stringRoot);
\ No newline at end of file
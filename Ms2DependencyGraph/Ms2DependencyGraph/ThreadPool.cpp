@@ -0,0 +1,135 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace
+{
+	thread_local bool isPoolThread = false;
+}
+
+ThreadPool::ThreadPool(int threadCount)
+{
+	if (threadCount <= 0)
+		threadCount = (int)std::thread::hardware_concurrency();
+
+	if (threadCount <= 0)
+		threadCount = 1;
+
+	for (int i = 0; i < threadCount; ++i)
+		Threads.push_back(std::thread(&ThreadPool::Run, this));
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> guard(Lock);
+
+		ShuttingDown = true;
+	}
+
+	TaskReady.notify_all();
+
+	for (std::thread& thread : Threads)
+		thread.join();
+}
+
+void ThreadPool::Queue(std::function<void()> task)
+{
+	{
+		std::lock_guard<std::mutex> guard(Lock);
+
+		Tasks.push_back(std::move(task));
+	}
+
+	TaskReady.notify_one();
+}
+
+void ThreadPool::Wait()
+{
+	std::unique_lock<std::mutex> guard(Lock);
+
+	TasksFinished.wait(guard, [this]() { return Tasks.size() == 0 && ActiveTasks == 0; });
+}
+
+void ThreadPool::Run()
+{
+	isPoolThread = true;
+
+	while (true)
+	{
+		std::function<void()> task;
+
+		{
+			std::unique_lock<std::mutex> guard(Lock);
+
+			TaskReady.wait(guard, [this]() { return ShuttingDown || Tasks.size() > 0; });
+
+			if (Tasks.size() == 0)
+				return;
+
+			task = std::move(Tasks.front());
+			Tasks.pop_front();
+
+			++ActiveTasks;
+		}
+
+		task();
+
+		{
+			std::lock_guard<std::mutex> guard(Lock);
+
+			--ActiveTasks;
+
+			if (Tasks.size() == 0 && ActiveTasks == 0)
+				TasksFinished.notify_all();
+		}
+	}
+}
+
+ThreadPool& getThreadPool()
+{
+	static ThreadPool pool;
+
+	return pool;
+}
+
+void parallelFor(int count, const std::function<void(int start, int end)>& body)
+{
+	if (count <= 0)
+		return;
+
+	ThreadPool& pool = getThreadPool();
+
+	int ranges = std::min(count, pool.GetThreadCount() * 4);
+
+	if (ranges <= 1 || isPoolThread)
+	{
+		body(0, count);
+
+		return;
+	}
+
+	std::mutex lock;
+	std::condition_variable rangesFinished;
+	int remaining = ranges;
+
+	for (int i = 0; i < ranges; ++i)
+	{
+		int start = (int)((long long)count * i / ranges);
+		int end = (int)((long long)count * (i + 1) / ranges);
+
+		pool.Queue([&body, &lock, &rangesFinished, &remaining, start, end]()
+		{
+			body(start, end);
+
+			std::lock_guard<std::mutex> guard(lock);
+
+			if (--remaining == 0)
+				rangesFinished.notify_all();
+		});
+	}
+
+	std::unique_lock<std::mutex> guard(lock);
+
+	rangesFinished.wait(guard, [&remaining]() { return remaining == 0; });
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <deque>
+
+class ThreadPool
+{
+public:
+	ThreadPool(int threadCount = 0);
+	~ThreadPool();
+
+	void Queue(std::function<void()> task);
+	void Wait();
+
+	int GetThreadCount() const { return (int)Threads.size(); }
+
+private:
+	std::mutex Lock;
+	std::condition_variable TaskReady;
+	std::condition_variable TasksFinished;
+	std::deque<std::function<void()>> Tasks;
+	std::vector<std::thread> Threads;
+	int ActiveTasks = 0;
+	bool ShuttingDown = false;
+
+	void Run();
+};
+
+ThreadPool& getThreadPool();
+
+// Splits [0, count) into ranges run on the shared pool and blocks until all of them finish. Called from a pool task it
+// runs the whole range inline instead, so nested use cannot deadlock.
+void parallelFor(int count, const std::function<void(int start, int end)>& body);
\ No newline at end of file
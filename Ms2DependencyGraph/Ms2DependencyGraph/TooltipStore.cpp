@@ -0,0 +1,161 @@
+#include "TooltipStore.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <tuple>
+#include <vector>
+
+#include "XmlParsing.h"
+
+namespace
+{
+	bool entryLess(const TooltipStoreEntry& left, const TooltipStoreEntry& right)
+	{
+		return std::make_tuple(left.Type, left.Id, left.Level) < std::make_tuple(right.Type, right.Id, right.Level);
+	}
+
+	void addTooltip(std::vector<TooltipStoreEntry>& entries, std::string& text, TooltipType type, int id, int level, const std::string& description)
+	{
+		if (description.size() == 0)
+			return;
+
+		entries.push_back(TooltipStoreEntry{ type, id, level, (uint32_t)text.size(), (uint32_t)description.size() });
+
+		text += description;
+	}
+
+	template <typename Data, typename Describe>
+	void addLevels(std::vector<TooltipStoreEntry>& entries, std::string& text, TooltipType type, int id, const Data& data, const Describe& describe)
+	{
+		if (data.Levels.size() == 0)
+			return;
+
+		if (data.ScalingLevels)
+		{
+			addTooltip(entries, text, type, id, -1, describe(data.Levels.begin()->second));
+
+			return;
+		}
+
+		for (const auto& level : data.Levels)
+			addTooltip(entries, text, type, id, level.first, describe(level.second));
+	}
+}
+
+bool writeTooltipStore(const fs::path& outputPath)
+{
+	std::vector<TooltipStoreEntry> entries;
+	std::string text;
+
+	for (const auto& skill : model().Skills)
+		addLevels(entries, text, TooltipType::Skill, skill.first, skill.second, [](const SkillLevelData& level) -> const std::string& { return level.Description; });
+
+	for (const auto& effect : model().Effects)
+		addLevels(entries, text, TooltipType::Effect, effect.first, effect.second, [](const AdditionalEffectLevelData& level) -> const std::string& { return level.Description; });
+
+	for (const auto& item : model().Items)
+		addTooltip(entries, text, TooltipType::Item, item.first, 0, item.second.Description);
+
+	std::sort(entries.begin(), entries.end(), entryLess);
+
+	std::error_code error;
+
+	if (outputPath.has_parent_path())
+		fs::create_directories(outputPath.parent_path(), error);
+
+	std::ofstream outFile(outputPath, std::ofstream::out | std::ofstream::binary);
+
+	if (!outFile.is_open())
+		return false;
+
+	TooltipStoreHeader header;
+
+	header.EntryCount = (uint32_t)entries.size();
+
+	outFile.write((const char*)&header, sizeof(header));
+	outFile.write((const char*)entries.data(), entries.size() * sizeof(TooltipStoreEntry));
+	outFile.write(text.data(), text.size());
+
+	return outFile.good();
+}
+
+bool readTooltipKey(const char* text, TooltipStoreEntry& key)
+{
+	static const std::pair<std::string_view, TooltipType> types[] = {
+		{ "skill", TooltipType::Skill },
+		{ "effect", TooltipType::Effect },
+		{ "item", TooltipType::Item }
+	};
+
+	std::string_view keyText = text;
+	size_t separator = keyText.find(':');
+
+	if (separator == std::string_view::npos)
+		return false;
+
+	const auto type = std::find_if(std::begin(types), std::end(types), [&keyText, separator](const auto& type) { return type.first == keyText.substr(0, separator); });
+
+	if (type == std::end(types))
+		return false;
+
+	const char* idText = text + separator + 1;
+	const char* levelText = strchr(idText, ':');
+
+	key = TooltipStoreEntry{ type->second, atoi(idText), type->second == TooltipType::Item ? 0 : -1 };
+
+	if (levelText != nullptr && type->second != TooltipType::Item)
+		key.Level = atoi(levelText + 1);
+
+	return true;
+}
+
+bool TooltipStore::Open(const fs::path& filePath)
+{
+	Entries = nullptr;
+	EntryCount = 0;
+	Text = std::string_view();
+
+	if (!File.Open(filePath))
+		return false;
+
+	std::string_view data = File.GetText();
+	TooltipStoreHeader header;
+
+	if (data.size() < sizeof(header))
+		return false;
+
+	memcpy(&header, data.data(), sizeof(header));
+
+	if (memcmp(header.Magic, TooltipStoreHeader().Magic, 4) != 0 || header.Version != 1)
+		return false;
+
+	size_t tableSize = (size_t)header.EntryCount * sizeof(TooltipStoreEntry);
+
+	if (data.size() < sizeof(header) + tableSize)
+		return false;
+
+	Entries = (const TooltipStoreEntry*)(data.data() + sizeof(header));
+	EntryCount = header.EntryCount;
+	Text = data.substr(sizeof(header) + tableSize);
+
+	return true;
+}
+
+std::string_view TooltipStore::Find(TooltipType type, int id, int level) const
+{
+	TooltipStoreEntry key{ type, id, level };
+
+	const TooltipStoreEntry* end = Entries + EntryCount;
+	const TooltipStoreEntry* entry = std::lower_bound(Entries, end, key, entryLess);
+
+	if (entry == end || entryLess(key, *entry) || (size_t)entry->Offset + entry->Length > Text.size())
+		return std::string_view();
+
+	return Text.substr(entry->Offset, entry->Length);
+}
+
+std::string_view TooltipStore::Find(const ReferenceData& reference) const
+{
+	return Find(reference.Type == ReferenceType::Skill ? TooltipType::Skill : TooltipType::Effect, reference.Id, reference.Level);
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+#include "MappedFile.h"
+#include "XmlData.h"
+
+namespace fs = std::filesystem;
+
+// Sidecar file holding every skill, effect and item description once, so graphs only need to name the node.
+// Layout: TooltipStoreHeader, EntryCount TooltipStoreEntry records sorted by (Type, Id, Level), then the raw UTF-8
+// text. Every field is little endian and 4 byte aligned so the file can be mapped and searched in place.
+struct TooltipStoreHeader
+{
+	char Magic[4] = { 'M', 'T', 'I', 'P' };
+	uint32_t Version = 1;
+	uint32_t EntryCount = 0;
+	uint32_t Flags = 0;
+};
+
+enum class TooltipType : uint32_t
+{
+	Effect = 0,
+	Skill = 1,
+	Item = 2
+};
+
+struct TooltipStoreEntry
+{
+	TooltipType Type = TooltipType::Effect;
+	int32_t Id = 0;
+	int32_t Level = 0;
+	uint32_t Offset = 0;
+	uint32_t Length = 0;
+};
+
+// Keys match the node names GraphData prints: scaling skills and effects use level -1, items use level 0.
+bool writeTooltipStore(const fs::path& outputPath);
+
+// "skill:<id>[:<level>]", "effect:<id>[:<level>]" or "item:<id>". Without a level, skills and effects are looked up as
+// scaling, at level -1
+bool readTooltipKey(const char* text, TooltipStoreEntry& key);
+
+class TooltipStore
+{
+public:
+	bool Open(const fs::path& filePath);
+
+	std::string_view Find(TooltipType type, int id, int level) const;
+	std::string_view Find(const ReferenceData& reference) const;
+
+private:
+	MappedFile File;
+	const TooltipStoreEntry* Entries = nullptr;
+	uint32_t EntryCount = 0;
+	std::string_view Text;
+};
\ No newline at end of file
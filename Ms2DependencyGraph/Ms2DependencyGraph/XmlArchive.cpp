@@ -0,0 +1,168 @@
+#include "XmlArchive.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+	struct PackedFile
+	{
+		std::string Path;
+		fs::path FilePath;
+		uint64_t Size = 0;
+	};
+}
+
+bool writeXmlArchive(const fs::path& sourceRoot, const fs::path& archivePath)
+{
+	std::vector<PackedFile> files;
+
+	for (auto file = fs::recursive_directory_iterator(sourceRoot); file != fs::recursive_directory_iterator(); ++file)
+	{
+		if (!fs::is_regular_file(file->symlink_status()))
+			continue;
+
+		files.push_back(PackedFile{ fs::relative(file->path(), sourceRoot).generic_string(), file->path(), (uint64_t)file->file_size() });
+	}
+
+	std::sort(files.begin(), files.end(), [](const PackedFile& left, const PackedFile& right) { return left.Path < right.Path; });
+
+	std::vector<XmlArchiveEntry> entries(files.size());
+	std::string paths;
+	uint64_t dataSize = 0;
+
+	for (size_t i = 0; i < files.size(); ++i)
+	{
+		XmlArchiveEntry& entry = entries[i];
+
+		entry.PathOffset = (uint32_t)paths.size();
+		entry.PathLength = (uint32_t)files[i].Path.size();
+		entry.DataOffset = dataSize;
+		entry.Size = files[i].Size;
+
+		paths += files[i].Path;
+		dataSize += files[i].Size;
+	}
+
+	paths.resize((paths.size() + 7) & ~(size_t)7);
+
+	if (archivePath.has_parent_path())
+		fs::create_directories(archivePath.parent_path());
+
+	std::ofstream outFile(archivePath, std::ofstream::out | std::ofstream::binary);
+
+	if (!outFile.is_open())
+		return false;
+
+	XmlArchiveHeader header;
+
+	header.EntryCount = (uint32_t)entries.size();
+	header.PathsSize = (uint32_t)paths.size();
+
+	outFile.write((const char*)&header, sizeof(header));
+	outFile.write((const char*)entries.data(), entries.size() * sizeof(XmlArchiveEntry));
+	outFile.write(paths.data(), paths.size());
+
+	std::vector<char> buffer;
+
+	for (const PackedFile& file : files)
+	{
+		std::ifstream inFile(file.FilePath, std::ifstream::in | std::ifstream::binary);
+
+		buffer.resize(file.Size);
+
+		if (!inFile.read(buffer.data(), buffer.size()))
+			return false;
+
+		outFile.write(buffer.data(), buffer.size());
+	}
+
+	return outFile.good();
+}
+
+bool XmlArchive::Open(const fs::path& filePath)
+{
+	Entries = nullptr;
+	EntryCount = 0;
+
+	if (!File.Open(filePath))
+		return false;
+
+	std::string_view data = File.GetText();
+	XmlArchiveHeader header;
+
+	if (data.size() < sizeof(header))
+		return false;
+
+	memcpy(&header, data.data(), sizeof(header));
+
+	if (memcmp(header.Magic, XmlArchiveHeader().Magic, 4) != 0 || header.Version != XmlArchiveHeader().Version)
+		return false;
+
+	size_t tableSize = (size_t)header.EntryCount * sizeof(XmlArchiveEntry);
+	size_t pathsSize = header.PathsSize;
+
+	if (data.size() < sizeof(header) + tableSize + pathsSize)
+		return false;
+
+	Entries = (const XmlArchiveEntry*)(data.data() + sizeof(header));
+	EntryCount = header.EntryCount;
+	Paths = data.substr(sizeof(header) + tableSize, pathsSize);
+	Data = data.substr(sizeof(header) + tableSize + pathsSize);
+
+	return true;
+}
+
+std::string_view XmlArchive::GetPath(const XmlArchiveEntry& entry) const
+{
+	if ((size_t)entry.PathOffset + entry.PathLength > Paths.size())
+		return std::string_view();
+
+	return Paths.substr(entry.PathOffset, entry.PathLength);
+}
+
+std::string_view XmlArchive::GetData(const XmlArchiveEntry& entry) const
+{
+	if (entry.DataOffset + entry.Size > Data.size())
+		return std::string_view();
+
+	return Data.substr(entry.DataOffset, entry.Size);
+}
+
+const XmlArchiveEntry* XmlArchive::Find(std::string_view path) const
+{
+	const XmlArchiveEntry* end = Entries + EntryCount;
+	const XmlArchiveEntry* entry = std::lower_bound(Entries, end, path, [this](const XmlArchiveEntry& entry, std::string_view path) { return GetPath(entry) < path; });
+
+	if (entry == end || GetPath(*entry) != path)
+		return nullptr;
+
+	return entry;
+}
+
+void XmlArchive::ForEach(std::string_view directory, bool recursiveSearch, const std::function<void(const XmlArchiveEntry&)>& callback) const
+{
+	std::string prefix(directory);
+
+	if (prefix.size() > 0 && prefix.back() != '/')
+		prefix.push_back('/');
+
+	const XmlArchiveEntry* end = Entries + EntryCount;
+	const XmlArchiveEntry* entry = std::lower_bound(Entries, end, prefix, [this](const XmlArchiveEntry& entry, const std::string& prefix) { return GetPath(entry) < prefix; });
+
+	for (; entry != end; ++entry)
+	{
+		std::string_view path = GetPath(*entry);
+
+		if (!path.starts_with(prefix))
+			break;
+
+		if (!recursiveSearch && path.find('/', prefix.size()) != std::string_view::npos)
+			continue;
+
+		callback(*entry);
+	}
+}
\ No newline at end of file
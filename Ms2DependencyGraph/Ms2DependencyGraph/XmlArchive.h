@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string_view>
+
+#include "MappedFile.h"
+
+namespace fs = std::filesystem;
+
+// Our own repacked copy of an extracted XML tree, built by --pack from the --xml tree. It isn't the client's m2h/m2d
+// format, so the tree still has to be extracted once; later runs then map one file instead of opening hundreds of
+// thousands of loose ones. Entries are stored as they are, uncompressed.
+// Layout: XmlArchiveHeader, EntryCount XmlArchiveEntry records sorted by path, the paths, then the file data. Paths are
+// relative to the tree root with '/' separators. Every field is little endian and aligned so the file can be mapped.
+struct XmlArchiveHeader
+{
+	char Magic[4] = { 'M', 'X', 'A', 'R' };
+	uint32_t Version = 2;
+	uint32_t EntryCount = 0;
+	uint32_t PathsSize = 0;
+};
+
+struct XmlArchiveEntry
+{
+	uint32_t PathOffset = 0;
+	uint32_t PathLength = 0;
+	uint64_t DataOffset = 0;
+	uint64_t Size = 0;
+};
+
+bool writeXmlArchive(const fs::path& sourceRoot, const fs::path& archivePath);
+
+class XmlArchive
+{
+public:
+	bool Open(const fs::path& filePath);
+	bool IsOpen() const { return Entries != nullptr; }
+
+	const XmlArchiveEntry* Find(std::string_view path) const;
+	std::string_view GetPath(const XmlArchiveEntry& entry) const;
+	std::string_view GetData(const XmlArchiveEntry& entry) const;
+
+	// Visits entries under a directory prefix in path order. Without recursiveSearch only its direct files are visited.
+	void ForEach(std::string_view directory, bool recursiveSearch, const std::function<void(const XmlArchiveEntry&)>& callback) const;
+
+private:
+	MappedFile File;
+	const XmlArchiveEntry* Entries = nullptr;
+	uint32_t EntryCount = 0;
+	std::string_view Paths;
+	std::string_view Data;
+};
\ No newline at end of file
@@ -0,0 +1,223 @@
+#include "XmlChunking.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+#include "XmlSource.h"
+#include "ParserUtils.h"
+#include "ThreadPool.h"
+
+namespace
+{
+	const size_t recordChunkSize = 1 << 20;
+
+	size_t findTagEnd(std::string_view text, size_t index)
+	{
+		char quote = 0;
+
+		for (; index < text.size(); ++index)
+		{
+			char character = text[index];
+
+			if (quote != 0)
+			{
+				if (character == quote)
+					quote = 0;
+			}
+			else if (character == '"' || character == '\'')
+				quote = character;
+			else if (character == '>')
+				return index;
+		}
+
+		return std::string_view::npos;
+	}
+
+	bool openRecords(XmlSourceFile& file, const fs::path& filePath, bool checkRoot, XmlRecordChunks& records)
+	{
+		if (!file.Open(filePath) || !splitRecords(file.GetText(), recordChunkSize, records))
+			return false;
+
+		if (!checkRoot)
+			return true;
+
+		SupportSettings fileFeature;
+		SupportSettings fileLocale;
+
+		return isRootEnabled(records.RootTag, &fileFeature, &fileLocale);
+	}
+
+	// Parses a bounded number of chunks at a time so memory stays proportional to the thread count, not the file.
+	template <typename Chunk, typename Parse, typename Visit>
+	void processChunks(const std::vector<std::string_view>& chunks, const Parse& parse, const Visit& visit)
+	{
+		size_t batchSize = (size_t)std::max(1, getThreadPool().GetThreadCount() * 2);
+
+		std::vector<Chunk> parsed;
+
+		for (size_t batchStart = 0; batchStart < chunks.size(); batchStart += batchSize)
+		{
+			int count = (int)std::min(batchSize, chunks.size() - batchStart);
+
+			// chunks are reset by parse rather than destroyed, so their storage carries over to the next batch
+			parsed.resize(count);
+
+			parallelFor(count, [&chunks, &parsed, &parse, batchStart](int start, int end)
+			{
+				for (int i = start; i < end; ++i)
+					parse(chunks[batchStart + i], parsed[i]);
+			});
+
+			for (Chunk& chunk : parsed)
+				visit(chunk);
+		}
+	}
+}
+
+bool splitRecords(std::string_view text, size_t chunkSize, XmlRecordChunks& output)
+{
+	output.RootTag = std::string_view();
+	output.Chunks.clear();
+
+	const size_t none = std::string_view::npos;
+
+	int depth = 0;
+	size_t index = 0;
+	size_t chunkStart = none;
+	size_t recordEnd = none;
+
+	while (index < text.size())
+	{
+		const char* found = (const char*)memchr(text.data() + index, '<', text.size() - index);
+
+		if (found == nullptr)
+			break;
+
+		index = found - text.data();
+
+		std::string_view tag = text.substr(index);
+		std::string_view terminator;
+
+		if (tag.starts_with("<?"))
+			terminator = "?>";
+		else if (tag.starts_with("<!--"))
+			terminator = "-->";
+		else if (tag.starts_with("<![CDATA["))
+			terminator = "]]>";
+		else if (tag.starts_with("<!"))
+			terminator = ">";
+
+		if (terminator.size() > 0)
+		{
+			index = text.find(terminator, index);
+
+			if (index == none)
+				return false;
+
+			index += terminator.size();
+
+			continue;
+		}
+
+		size_t tagEnd = findTagEnd(text, index);
+
+		if (tagEnd == none)
+			return false;
+
+		bool isClosing = tag.size() > 1 && tag[1] == '/';
+		bool isSelfClosing = !isClosing && text[tagEnd - 1] == '/';
+		bool endsRecord = false;
+
+		if (isClosing)
+		{
+			--depth;
+
+			endsRecord = depth == 1;
+		}
+		else
+		{
+			if (depth == 0)
+				output.RootTag = text.substr(index, tagEnd + 1 - index);
+			else if (depth == 1 && chunkStart == none)
+				chunkStart = index;
+
+			if (!isSelfClosing)
+				++depth;
+			else
+				endsRecord = depth == 1;
+		}
+
+		index = tagEnd + 1;
+
+		if (endsRecord)
+		{
+			recordEnd = index;
+
+			if (recordEnd - chunkStart >= chunkSize)
+			{
+				output.Chunks.push_back(text.substr(chunkStart, recordEnd - chunkStart));
+
+				chunkStart = none;
+			}
+		}
+
+		if (depth <= 0)
+			break;
+	}
+
+	if (chunkStart != none && recordEnd != none && recordEnd > chunkStart)
+		output.Chunks.push_back(text.substr(chunkStart, recordEnd - chunkStart));
+
+	return output.RootTag.size() > 0;
+}
+
+void forEachRecord(const fs::path& filePath, bool checkRoot, const std::function<void(const XmlStreamElement&)>& callback)
+{
+	XmlSourceFile file;
+	XmlRecordChunks records;
+
+	if (!openRecords(file, filePath, checkRoot, records))
+		return;
+
+	processChunks<std::vector<XmlStreamElement>>(records.Chunks, [](std::string_view chunk, std::vector<XmlStreamElement>& elements)
+	{
+		XmlStreamReader reader;
+
+		elements.clear();
+		reader.Open(chunk);
+
+		while (reader.NextElement())
+			if (reader.GetElement().Depth == 0)
+				elements.push_back(reader.GetElement());
+	},
+	[&callback](const std::vector<XmlStreamElement>& elements)
+	{
+		for (const XmlStreamElement& element : elements)
+			callback(element);
+	});
+}
+
+void forEachRecordElement(const fs::path& filePath, bool checkRoot, const std::function<void(tinyxml2::XMLElement*)>& callback)
+{
+	XmlSourceFile file;
+	XmlRecordChunks records;
+
+	if (!openRecords(file, filePath, checkRoot, records))
+		return;
+
+	processChunks<std::unique_ptr<tinyxml2::XMLDocument>>(records.Chunks, [](std::string_view chunk, std::unique_ptr<tinyxml2::XMLDocument>& document)
+	{
+		if (document == nullptr)
+			document = std::make_unique<tinyxml2::XMLDocument>();
+		else
+			document->Clear();
+
+		document->Parse(chunk.data(), chunk.size());
+	},
+	[&callback](const std::unique_ptr<tinyxml2::XMLDocument>& document)
+	{
+		for (tinyxml2::XMLElement* element = document->FirstChildElement(); element; element = element->NextSiblingElement())
+			callback(element);
+	});
+}
\ No newline at end of file
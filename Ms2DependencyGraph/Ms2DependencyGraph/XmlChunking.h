@@ -0,0 +1,26 @@
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+#include "tinyxml2.h"
+#include "XmlStreamReader.h"
+
+namespace fs = std::filesystem;
+
+struct XmlRecordChunks
+{
+	std::string_view RootTag;
+	std::vector<std::string_view> Chunks;
+};
+
+// Splits a flat table into runs of whole depth 1 records, each roughly chunkSize bytes. Returns false if no root element was found.
+bool splitRecords(std::string_view text, size_t chunkSize, XmlRecordChunks& output);
+
+// Both walk the direct children of the root element in file order. The file is memory mapped, cut on record boundaries
+// and the chunks are parsed on the thread pool, but the callback always runs on the calling thread. With checkRoot
+// set nothing is visited when the root element itself is disabled.
+void forEachRecord(const fs::path& filePath, bool checkRoot, const std::function<void(const XmlStreamElement&)>& callback);
+void forEachRecordElement(const fs::path& filePath, bool checkRoot, const std::function<void(tinyxml2::XMLElement*)>& callback);
\ No newline at end of file
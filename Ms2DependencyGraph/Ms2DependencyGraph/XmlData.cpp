@@ -1,5 +1,7 @@
 #include "XmlData.h"
 
+#include "XmlParsing.h"
+
 std::ostream& operator<<(std::ostream& out, const ReferenceData& reference)
 {
 	if (reference.Type == ReferenceType::Skill)
@@ -13,4 +15,9 @@ std::ostream& operator<<(std::ostream& out, const ReferenceData& reference)
 		out << "_" << reference.Level;
 
 	return out;
+}
+
+std::ostream& operator<<(std::ostream& out, const PooledString& text)
+{
+	return out.write(model().LabelPool.data() + text.Offset, text.Length);
 }
\ No newline at end of file
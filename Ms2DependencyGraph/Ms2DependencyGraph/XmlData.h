@@ -193,18 +193,24 @@ struct ReferenceData
 	ReferenceType Type = ReferenceType::Effect;
 	int Id = 0;
 	int Level = 0;
+
+	bool operator==(const ReferenceData&) const = default;
 };
 
 struct EffectReferenceData : public ReferenceData
 {
 	int MinStacks = 0;
 	int MaxStacks = 0;
+
+	bool operator==(const EffectReferenceData&) const = default;
 };
 
 struct TriggerReferenceData : public ReferenceData
 {
 	SkillTarget Target = SkillTarget::SkillTarget;
 	ConditionReferenceType ConditionType = ConditionReferenceType::Require;
+
+	bool operator==(const TriggerReferenceData&) const = default;
 };
 
 struct BeginCondition
@@ -213,6 +219,8 @@ struct BeginCondition
 	SkillTarget EventTarget = SkillTarget::SkillTarget;
 	EventCondition EventCondition = EventCondition::None;
 	std::vector<int> RequireSkillCodes;
+
+	bool operator==(const BeginCondition&) const = default;
 };
 
 struct ConditionSkill
@@ -227,12 +235,35 @@ struct ConditionSkill
 	std::vector<ReferenceData> RandomCasts;
 
 	BeginCondition Condition;
+
+	bool operator==(const ConditionSkill&) const = default;
 };
 
 struct ModifyReference : public ReferenceData
 {
 	ModifyReferenceType ModificationType = ModifyReferenceType::Cancel;
 	int Offset = 0;
+
+	bool operator==(const ModifyReference&) const = default;
+};
+
+// Label or tooltip text that was escaped once at load, stored as a slice of the model's LabelPool.
+struct PooledString
+{
+	unsigned int Offset = 0;
+	unsigned int Length = 0;
+
+	bool operator==(const PooledString&) const = default;
+};
+
+// Filled in by computeSkillTraits once everything is loaded.
+struct SkillTraits
+{
+	unsigned char IsProjectile : 1 = 0;
+	unsigned char IsSensor : 1 = 0;
+	unsigned char IsSplash : 1 = 0;
+
+	bool operator==(const SkillTraits&) const = default;
 };
 
 struct AdditionalEffectLevelData;
@@ -241,18 +272,22 @@ struct AdditionalEffectData
 {
 	bool ScalingLevels = true;
 	std::unordered_map<int, AdditionalEffectLevelData> Levels;
+
+	bool operator==(const AdditionalEffectData&) const = default;
 };
 
 struct AdditionalEffectLevelData
 {
 	std::string Name;
 	std::string Description;
+	PooledString EscapedName;
+	PooledString EscapedDescription;
 
 	SupportSettings Feature;
 	SupportSettings Locale;
 	
-	short Type;
-	short SubType;
+	short Type = 0;
+	short SubType = 0;
 	int ResetCondition = 0;
 	int KeepCondition = 0;
 	int MaxStacks = 0;
@@ -264,6 +299,8 @@ struct AdditionalEffectLevelData
 	AdditionalEffectLevelData() {}
 
 	AdditionalEffectLevelData(const SupportSettings& feature, const SupportSettings& locale) : Feature(feature), Locale(locale) {}
+
+	bool operator==(const AdditionalEffectLevelData&) const = default;
 };
 
 struct SkillLevelData;
@@ -271,6 +308,7 @@ struct SkillLevelData;
 struct SkillData
 {
 	std::string Name;
+	PooledString EscapedName;
 
 	SupportSettings Feature;
 	SupportSettings Locale;
@@ -279,7 +317,10 @@ struct SkillData
 	short Type = 0;
 	short SubType = 0;
 	bool ScalingLevels = true;
+	SkillTraits Traits;
 	std::unordered_map<int, SkillLevelData> Levels;
+
+	bool operator==(const SkillData&) const = default;
 };
 
 struct ChangeSkillReference
@@ -287,6 +328,8 @@ struct ChangeSkillReference
 	EffectReferenceData Effect;
 	ReferenceData Skill;
 	ReferenceData OriginSkill;
+
+	bool operator==(const ChangeSkillReference&) const = default;
 };
 
 struct ComboReference
@@ -296,6 +339,8 @@ struct ComboReference
 	ReferenceData OriginSkill;
 	ReferenceData InputSkill;
 	ReferenceData OutputSkill;
+
+	bool operator==(const ComboReference&) const = default;
 };
 
 struct SkillAttack;
@@ -306,6 +351,8 @@ struct SkillMotion
 	int TotalCubePaths = 0;
 
 	std::vector<SkillAttack> Attacks;
+
+	bool operator==(const SkillMotion&) const = default;
 };
 
 struct SkillAttack
@@ -317,17 +364,22 @@ struct SkillAttack
 	unsigned char AttackMaterial = 0;
 
 	std::vector<ConditionSkill> Triggers;
+
+	bool operator==(const SkillAttack&) const = default;
 };
 
 struct SkillLevelData
 {
 	std::string Description;
+	PooledString EscapedDescription;
 	int TotalAttacks = 0;
 	int TotalPaths = 0;
 	int TotalCubePaths = 0;
 	int TotalMotionsWithPaths = 0;
 	int TotalMotionsWithCubePaths = 0;
 
+	SkillTraits Traits;
+
 	SupportSettings Feature;
 	SupportSettings Locale;
 
@@ -340,6 +392,8 @@ struct SkillLevelData
 	SkillLevelData() {}
 
 	SkillLevelData(const SupportSettings& feature, const SupportSettings& locale) : Feature(feature), Locale(locale) {}
+
+	bool operator==(const SkillLevelData&) const = default;
 };
 
 struct JobSkill
@@ -441,6 +495,8 @@ struct ItemData
 	std::string Name;
 	std::string Class;
 	std::string Description;
+	PooledString EscapedName;
+	PooledString EscapedDescription;
 
 	SupportSettings Feature;
 	SupportSettings Locale;
@@ -456,4 +512,5 @@ struct ItemData
 	ItemData(const SupportSettings& feature, const SupportSettings& locale) : Feature(feature), Locale(locale) {}
 };
 
-std::ostream& operator<<(std::ostream& out, const ReferenceData& reference);
\ No newline at end of file
+std::ostream& operator<<(std::ostream& out, const ReferenceData& reference);
+std::ostream& operator<<(std::ostream& out, const PooledString& text);
\ No newline at end of file
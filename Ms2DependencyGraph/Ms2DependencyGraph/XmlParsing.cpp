@@ -1,26 +1,32 @@
 #include "XmlParsing.h"
 
-std::unordered_map<int, MagicPathData> magicPaths;
-std::unordered_map<int, AdditionalEffectData> effects;
-std::unordered_map<int, SkillData> skills;
-std::unordered_map<JobCode, JobData> jobs;
-std::unordered_map<int, SetBonusOptionData> setBonusOptions;
-std::unordered_map<int, SetBonusData> setBonuses;
-std::unordered_map<int, ItemData> items;
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <iostream>
 
-void ParseMagicPaths(const fs::path& filePath)
-{
-	tinyxml2::XMLDocument document;
+#include "XmlChunking.h"
+#include "ParserSchema.h"
+#include "IngestStats.h"
+#include "XmlSource.h"
 
-	document.LoadFile(filePath.string().c_str());
+namespace
+{
+	GraphModel loadedModel;
+}
 
-	tinyxml2::XMLElement* rootElement = document.RootElement();
+GraphModel* sharedModel = &loadedModel;
+thread_local GraphModel* threadModel = nullptr;
+ItemFilterSettings itemFilter;
+XmlParserMode xmlParserMode = XmlParserMode::InSitu;
 
-	for (tinyxml2::XMLElement* typeElement = rootElement->FirstChildElement(); typeElement; typeElement = typeElement->NextSiblingElement())
+void ParseMagicPaths(const fs::path& filePath)
+{
+	forEachRecordElement(filePath, false, [](tinyxml2::XMLElement* typeElement)
 	{
 		int id = readAttribute<int>(typeElement, "id", 0);
 
-		MagicPathData& path = magicPaths[id];
+		MagicPathData& path = model().MagicPaths[id];
 
 		for (tinyxml2::XMLElement* moveElement = typeElement->FirstChildElement(); moveElement; moveElement = moveElement->NextSiblingElement())
 		{
@@ -35,16 +41,57 @@ void ParseMagicPaths(const fs::path& filePath)
 
 			move.Velocity = readAttribute<float>(moveElement, "vel", 0);
 		}
-	}
+	});
 }
 
-void ParseBeginCondition(tinyxml2::XMLElement* node, BeginCondition& condition)
+constexpr auto conditionSkillSchema = schema(
+	schemaField("splash", &ConditionSkill::IsSplash, false),
+	schemaField("onlySensingActive", &ConditionSkill::OnlySensingActive, false),
+	schemaField("nonTargetActive", &ConditionSkill::NonTargetActive, false),
+	schemaField("skillTarget", &ConditionSkill::SkillTarget, SkillTarget::SkillTarget),
+	schemaField("skillOwner", &ConditionSkill::SkillOwner, SkillTarget::SkillTarget),
+	schemaField("splash", &ConditionSkill::Reference, &ReferenceData::Type, ReferenceType::Effect),
+	schemaField("skillID", &ConditionSkill::Reference, &ReferenceData::Id, 0),
+	schemaField("level", &ConditionSkill::Reference, &ReferenceData::Level, 0)
+);
+
+constexpr auto effectBasicPropertySchema = schema(
+	schemaField("type", &AdditionalEffectLevelData::Type, 0),
+	schemaField("subType", &AdditionalEffectLevelData::SubType, 0),
+	schemaField("keepCondition", &AdditionalEffectLevelData::KeepCondition, 0),
+	schemaField("resetCondition", &AdditionalEffectLevelData::ResetCondition, 0),
+	schemaField("maxBuffCount", &AdditionalEffectLevelData::MaxStacks, 0),
+	schemaField("group", &AdditionalEffectLevelData::Group, 0)
+);
+
+constexpr auto skillKindsSchema = schema(
+	schemaField("type", &SkillData::Type, 0),
+	schemaField("subType", &SkillData::SubType, 0),
+	schemaField("immediateActive", &SkillData::ImmediateActive, false)
+);
+
+constexpr auto skillAttackSchema = schema(
+	schemaField("magicPathID", &SkillAttack::MagicPathId, 0),
+	schemaField("cubeMagicPathID", &SkillAttack::CubeMagicPathId, 0)
+);
+
+constexpr auto skillAttackRangeSchema = schema(
+	schemaField("castTarget", &SkillAttack::CastTarget, ApplyTarget::None),
+	schemaField("applyTarget", &SkillAttack::ApplyTarget, ApplyTarget::None)
+);
+
+constexpr auto skillAttackDamageSchema = schema(
+	schemaField("attackMaterial", &SkillAttack::AttackMaterial, 0)
+);
+
+template <typename Node>
+void ParseBeginCondition(Node node, BeginCondition& condition)
 {
-	for (tinyxml2::XMLElement* conditionElement = node->FirstChildElement(); conditionElement; conditionElement = conditionElement->NextSiblingElement())
+	for (Node conditionElement = node->FirstChildElement(); conditionElement; conditionElement = conditionElement->NextSiblingElement())
 	{
-		const char* name = conditionElement->Name();
+		uint64_t nameHash = schemaHash(conditionElement->Name());
 
-		if (strcmp(name, "requireSkillCodes") == 0)
+		if (nameHash == schemaName("requireSkillCodes"))
 		{
 			int skillId = readAttribute<int>(conditionElement, "code", 0);
 
@@ -53,15 +100,15 @@ void ParseBeginCondition(tinyxml2::XMLElement* node, BeginCondition& condition)
 			continue;
 		}
 
-		if (strcmp(name, "owner") != 0 && strcmp(name, "target") != 0 && strcmp(name, "caster") != 0)
+		if (nameHash != schemaName("owner") && nameHash != schemaName("target") && nameHash != schemaName("caster"))
 			continue;
 
 		SkillTarget target = SkillTarget::Owner;
 
-		if (strcmp(name, "target") != 0)
+		if (nameHash != schemaName("target"))
 			target = SkillTarget::Target;
 
-		if (strcmp(name, "caster") != 0)
+		if (nameHash != schemaName("caster"))
 			target = SkillTarget::Caster;
 
 		int hasBuffID = readAttribute<int>(conditionElement, "hasBuffID", 0);
@@ -123,16 +170,10 @@ void ParseBeginCondition(tinyxml2::XMLElement* node, BeginCondition& condition)
 		node = node;
 }
 
-void ParseConditionSkill(tinyxml2::XMLElement* node, ConditionSkill& conditionSkill)
+template <typename Node>
+void ParseConditionSkill(Node node, ConditionSkill& conditionSkill)
 {
-	conditionSkill.IsSplash = readAttribute<bool>(node, "splash", 0);
-	conditionSkill.OnlySensingActive = readAttribute<bool>(node, "onlySensingActive", 0);
-	conditionSkill.NonTargetActive = readAttribute<bool>(node, "nonTargetActive", 0);
-	conditionSkill.SkillTarget = (SkillTarget)readAttribute<int>(node, "skillTarget", 0);
-	conditionSkill.SkillOwner = (SkillTarget)readAttribute<int>(node, "skillOwner", 0);
-	conditionSkill.Reference.Type = (ReferenceType)readAttribute<int>(node, "splash", 0);
-	conditionSkill.Reference.Id = readAttribute<int>(node, "skillID", 0);
-	conditionSkill.Reference.Level = readAttribute<int>(node, "level", 0);
+	readSchema(node, conditionSkill, conditionSkillSchema);
 
 	if (readAttribute<bool>(node, "randomCast", false))
 	{
@@ -152,27 +193,12 @@ void ParseConditionSkill(tinyxml2::XMLElement* node, ConditionSkill& conditionSk
 	ParseBeginCondition(node->FirstChildElement(), conditionSkill.Condition);
 }
 
-void ParseAdditionalEffect(const fs::path& filePath)
+template <typename Node>
+void ParseAdditionalEffectLevels(Node rootElement, int effectId, AdditionalEffectData& effect)
 {
-	int effectId = atoi(filePath.stem().string().c_str());
-
-	AdditionalEffectData& effect = effects[effectId];
-
-	tinyxml2::XMLDocument document;
-
-	document.LoadFile(filePath.string().c_str());
-
-	tinyxml2::XMLElement* rootElement = document.RootElement();
-
-	SupportSettings fileFeature;
-	SupportSettings fileLocale;
-
-	if (!isNodeEnabled(rootElement, &fileFeature, &fileLocale))
-		return;
-
-	for (tinyxml2::XMLElement* levelElement = rootElement->FirstChildElement(); levelElement; levelElement = levelElement->NextSiblingElement())
+	for (Node levelElement = rootElement->FirstChildElement(); levelElement; levelElement = levelElement->NextSiblingElement())
 	{
-		tinyxml2::XMLElement* basicPropertyElement = levelElement->FirstChildElement("BasicProperty");
+		Node basicPropertyElement = levelElement->FirstChildElement("BasicProperty");
 
 		if (basicPropertyElement == nullptr)
 			continue;
@@ -186,12 +212,7 @@ void ParseAdditionalEffect(const fs::path& filePath)
 
 		levelData = AdditionalEffectLevelData(levelData.Feature, levelData.Locale);
 
-		levelData.Type = readAttribute<int>(basicPropertyElement, "type", 0);
-		levelData.SubType = readAttribute<int>(basicPropertyElement, "subType", 0);
-		levelData.KeepCondition = readAttribute<int>(basicPropertyElement, "keepCondition", 0);
-		levelData.ResetCondition = readAttribute<int>(basicPropertyElement, "resetCondition", 0);
-		levelData.MaxStacks = readAttribute<int>(basicPropertyElement, "maxBuffCount", 0);
-		levelData.Group = readAttribute<int>(basicPropertyElement, "group", 0);
+		readSchema(basicPropertyElement, levelData, effectBasicPropertySchema);
 
 		if (levelData.ResetCondition == 1 && levelData.MaxStacks > 1)
 		{
@@ -202,11 +223,11 @@ void ParseAdditionalEffect(const fs::path& filePath)
 			levelData.MaxStacks += 0;
 		}
 
-		for (tinyxml2::XMLElement* propertyElement = levelElement->FirstChildElement(); propertyElement; propertyElement = propertyElement->NextSiblingElement())
+		for (Node propertyElement = levelElement->FirstChildElement(); propertyElement; propertyElement = propertyElement->NextSiblingElement())
 		{
-			const char* propertyName = propertyElement->Name();
+			uint64_t propertyHash = schemaHash(propertyElement->Name());
 
-			if (strcmp(propertyName, "splashSkill") == 0 || strcmp(propertyName, "conditionSkill") == 0)
+			if (propertyHash == schemaName("splashSkill") || propertyHash == schemaName("conditionSkill"))
 			{
 				levelData.Triggers.push_back(ConditionSkill());
 
@@ -215,14 +236,14 @@ void ParseAdditionalEffect(const fs::path& filePath)
 				continue;
 			}
 
-			if (strcmp(propertyName, "beginCondition") == 0)
+			if (propertyHash == schemaName("beginCondition"))
 			{
 				ParseBeginCondition(propertyElement, levelData.Condition);
 
 				continue;
 			}
 
-			if (strcmp(propertyName, "ModifyOverlapCountProperty") == 0)
+			if (propertyHash == schemaName("ModifyOverlapCountProperty"))
 			{
 				std::vector<int> effectCodes;
 				std::vector<int> offsetCounts;
@@ -236,7 +257,7 @@ void ParseAdditionalEffect(const fs::path& filePath)
 				continue;
 			}
 
-			if (strcmp(propertyName, "ModifyEffectDurationProperty") == 0)
+			if (propertyHash == schemaName("ModifyEffectDurationProperty"))
 			{
 				std::vector<int> effectCodes;
 
@@ -248,7 +269,7 @@ void ParseAdditionalEffect(const fs::path& filePath)
 				continue;
 			}
 
-			if (strcmp(propertyName, "ResetSkillCoolDownTimeProperty") == 0)
+			if (propertyHash == schemaName("ResetSkillCoolDownTimeProperty"))
 			{
 				std::vector<int> skillCodes;
 
@@ -260,7 +281,7 @@ void ParseAdditionalEffect(const fs::path& filePath)
 				continue;
 			}
 
-			if (strcmp(propertyName, "ImmuneEffectProperty") == 0)
+			if (propertyHash == schemaName("ImmuneEffectProperty"))
 			{
 				std::vector<int> immuneCodes;
 
@@ -279,7 +300,7 @@ void ParseAdditionalEffect(const fs::path& filePath)
 				continue;
 			}
 
-			if (strcmp(propertyName, "CancelEffectProperty") == 0)
+			if (propertyHash == schemaName("CancelEffectProperty"))
 			{
 				std::vector<int> cancelCodes;
 
@@ -311,46 +332,29 @@ void ParseAdditionalEffect(const fs::path& filePath)
 	}
 }
 
-void ParseSkill(const fs::path& filePath)
+template <typename Node>
+void ParseSkillLevels(Node rootElement, int skillId, SkillData& skill)
 {
-	int skillId = atoi(filePath.stem().string().c_str());
-
-	SkillData& skill = skills[skillId];
-
-	tinyxml2::XMLDocument document;
-
-	document.LoadFile(filePath.string().c_str());
-
-	tinyxml2::XMLElement* rootElement = document.RootElement();
-
-	SupportSettings fileFeature;
-	SupportSettings fileLocale;
-
-	if (!isNodeEnabled(rootElement, &fileFeature, &fileLocale))
-		return;
-
-	for (tinyxml2::XMLElement* childElement = rootElement->FirstChildElement(); childElement; childElement = childElement->NextSiblingElement())
+	for (Node childElement = rootElement->FirstChildElement(); childElement; childElement = childElement->NextSiblingElement())
 	{
-		const char* childName = childElement->Name();
+		uint64_t childHash = schemaHash(childElement->Name());
 
-		if (strcmp(childName, "basic") == 0)
+		if (childHash == schemaName("basic"))
 		{
 			if (!isNodeEnabled(childElement, &skill.Feature, &skill.Locale))
 				continue;
 
-			tinyxml2::XMLElement* kindsElement = childElement->FirstChildElement("kinds");
+			Node kindsElement = childElement->FirstChildElement("kinds");
 
 			if (kindsElement == nullptr)
 				continue;
 
-			skill.Type = readAttribute<int>(kindsElement, "type", 0);
-			skill.SubType = readAttribute<int>(kindsElement, "subType", 0);
-			skill.ImmediateActive = readAttribute<bool>(kindsElement, "immediateActive", false);
+			readSchema(kindsElement, skill, skillKindsSchema);
 
 			continue;
 		}
 
-		if (strcmp(childName, "level") != 0)
+		if (childHash != schemaName("level"))
 			continue;
 
 		int level = readAttribute<int>(childElement, "value", 0);
@@ -371,18 +375,18 @@ void ParseSkill(const fs::path& filePath)
 		int splashLife = -1;
 		int splashCooldown = -1;
 
-		for (tinyxml2::XMLElement* propertyElement = childElement->FirstChildElement(); propertyElement; propertyElement = propertyElement->NextSiblingElement())
+		for (Node propertyElement = childElement->FirstChildElement(); propertyElement; propertyElement = propertyElement->NextSiblingElement())
 		{
-			const char* propertyName = propertyElement->Name();
+			uint64_t propertyHash = schemaHash(propertyElement->Name());
 
-			if (strcmp(propertyName, "beginCondition") == 0)
+			if (propertyHash == schemaName("beginCondition"))
 			{
 				ParseBeginCondition(propertyElement, levelData.Condition);
 
 				continue;
 			}
 
-			if (strcmp(propertyName, "changeSkill") == 0)
+			if (propertyHash == schemaName("changeSkill"))
 			{
 				std::vector<int> effectID;
 				std::vector<int> effectLevel;
@@ -415,7 +419,7 @@ void ParseSkill(const fs::path& filePath)
 				continue;
 			}
 
-			if (strcmp(propertyName, "combo") == 0)
+			if (propertyHash == schemaName("combo"))
 			{
 				levelData.Combo.IsCombo = readAttribute<bool>(propertyElement, "comboSkill", false);
 				levelData.Combo.IsCharging = readAttribute<bool>(propertyElement, "chargingSkill", false);
@@ -426,24 +430,24 @@ void ParseSkill(const fs::path& filePath)
 				continue;
 			}
 
-			if (strcmp(propertyName, "conditionSkill") == 0)
+			if (propertyHash == schemaName("conditionSkill"))
 			{
 				levelData.Passives.push_back(ConditionSkill());
 
 				ParseConditionSkill(propertyElement, levelData.Passives.back());
 			}
 
-			if (strcmp(propertyName, "motion") == 0)
+			if (propertyHash == schemaName("motion"))
 			{
 				levelData.Motions.push_back(SkillMotion{});
 
 				SkillMotion& motion = levelData.Motions.back();
 
-				for (tinyxml2::XMLElement* motionNodeElement = propertyElement->FirstChildElement(); motionNodeElement; motionNodeElement = motionNodeElement->NextSiblingElement())
+				for (Node motionNodeElement = propertyElement->FirstChildElement(); motionNodeElement; motionNodeElement = motionNodeElement->NextSiblingElement())
 				{
-					const char* motionNodeName = motionNodeElement->Name();
+					uint64_t motionNodeHash = schemaHash(motionNodeElement->Name());
 
-					if (strcmp(motionNodeName, "motionProperty") == 0)
+					if (motionNodeHash == schemaName("motionProperty"))
 					{
 						int splashLifeTick = readAttribute<int>(motionNodeElement, "splashLifeTick", 0);
 						int splashInvokeCoolTick = readAttribute<int>(motionNodeElement, "splashInvokeCoolTick", 0);
@@ -464,40 +468,38 @@ void ParseSkill(const fs::path& filePath)
 						continue;
 					}
 
-					if (strcmp(motionNodeName, "attack") != 0)
+					if (motionNodeHash != schemaName("attack"))
 						continue;
 
 					motion.Attacks.push_back(SkillAttack{});
 
 					SkillAttack& attack = motion.Attacks.back();
 
-					attack.MagicPathId = readAttribute<int>(motionNodeElement, "magicPathID", 0);
-					attack.CubeMagicPathId = readAttribute<int>(motionNodeElement, "cubeMagicPathID", 0);
+					readSchema(motionNodeElement, attack, skillAttackSchema);
 
 					++levelData.TotalAttacks;
 
 					bool hasSplash = false;
 
-					for (tinyxml2::XMLElement* childElement = motionNodeElement->FirstChildElement(); childElement; childElement = childElement->NextSiblingElement())
+					for (Node childElement = motionNodeElement->FirstChildElement(); childElement; childElement = childElement->NextSiblingElement())
 					{
-						const char* childName = childElement->Name();
+						uint64_t childHash = schemaHash(childElement->Name());
 
-						if (strcmp(childName, "rangeProperty") == 0)
+						if (childHash == schemaName("rangeProperty"))
 						{
-							attack.CastTarget = (ApplyTarget)readAttribute<int>(childElement, "castTarget", 0);
-							attack.ApplyTarget = (ApplyTarget)readAttribute<int>(childElement, "applyTarget", 0);
+							readSchema(childElement, attack, skillAttackRangeSchema);
 
 							continue;
 						}
 
-						if (strcmp(childName, "damageProperty") == 0)
+						if (childHash == schemaName("damageProperty"))
 						{
-							attack.AttackMaterial = readAttribute<unsigned char>(childElement, "attackMaterial", 0);
+							readSchema(childElement, attack, skillAttackDamageSchema);
 
 							continue;
 						}
 
-						if (strcmp(childName, "conditionSkill") != 0)
+						if (childHash != schemaName("conditionSkill"))
 							continue;
 
 						attack.Triggers.push_back(ConditionSkill());
@@ -582,193 +584,278 @@ void ParseSkill(const fs::path& filePath)
 	}
 }
 
-void ParseStrings(const fs::path& filePath)
+// Parses the file with the parser xmlParserMode picks. In verify mode both parsers run over the same text and the two
+// models are compared, tinyxml2's result is the one kept.
+template <typename Data, typename Parse>
+void parseTableFile(const XmlTableFile& tableFile, Data& data, const Parse& parse)
 {
-	std::string fileNameString = filePath.stem().string();
-	const char* fileName = fileNameString.c_str();
+	XmlSourceFile file;
 
-	const auto strcmp_s = [] <size_t Length> (const char* left, const char(&right)[Length])
+	if (!file.Open(tableFile))
+		return;
+
+	std::string_view text = file.GetText();
+
+	SupportSettings fileFeature;
+	SupportSettings fileLocale;
+
+	if (!isRootEnabled(text, &fileFeature, &fileLocale))
 	{
-		return strncmp(left, right, Length - 1);
-	};
+		++ingestStats.EarlyRejectedFiles;
+
+		return;
+	}
 
-	if (strcmp_s(fileName, "korskilldescription") == 0)
+	thread_local XmlSpanDocument spanDocument;
+
+	if (xmlParserMode == XmlParserMode::InSitu)
 	{
-		tinyxml2::XMLDocument document;
+		if (spanDocument.Parse(text))
+			parse(spanDocument.RootElement(), data);
 
-		document.LoadFile(filePath.string().c_str());
+		return;
+	}
 
-		tinyxml2::XMLElement* rootElement = document.RootElement();
+	Data inSituData;
 
-		SupportSettings fileFeature;
-		SupportSettings fileLocale;
+	if (xmlParserMode == XmlParserMode::Verify)
+	{
+		inSituData = data;
 
-		if (!isNodeEnabled(rootElement, &fileFeature, &fileLocale))
-			return;
+		if (spanDocument.Parse(text))
+			parse(spanDocument.RootElement(), inSituData);
+	}
 
-		for (tinyxml2::XMLElement* keyElement = rootElement->FirstChildElement(); keyElement; keyElement = keyElement->NextSiblingElement())
-		{
-			SupportSettings keyFeature;
-			SupportSettings keyLocale;
+	tinyxml2::XMLDocument& document = getThreadDocument();
 
-			if (!isNodeEnabled(rootElement, &keyFeature, &keyLocale))
-				continue;
+	document.Parse(text.data(), text.size());
 
-			int skillId = readAttribute<int>(keyElement, "id", 0);
+	if (document.RootElement() != nullptr)
+		parse(document.RootElement(), data);
 
-			auto skillIndex = skills.find(skillId);
+	if (xmlParserMode != XmlParserMode::Verify)
+		return;
 
-			if (skillIndex == skills.end())
-				continue;
+	++ingestStats.VerifiedFiles;
 
-			SkillData& skill = skillIndex->second;
+	if (inSituData == data)
+		return;
 
-			int skillLevel = readAttribute<int>(keyElement, "level", 0);
+	++ingestStats.MismatchedFiles;
 
-			auto skillLevelIndex = skill.Levels.find(skillLevel);
+	std::cerr << "in situ parser mismatch: " << tableFile.Path.string() << std::endl;
+}
 
-			if (skillLevelIndex == skill.Levels.end())
-				continue;
+void ParseAdditionalEffect(const XmlTableFile& file)
+{
+	int effectId = file.Id;
 
-			const tinyxml2::XMLAttribute* description = keyElement->FindAttribute("uiDescription");
+	parseTableFile(file, model().Effects[effectId], [effectId](auto rootElement, AdditionalEffectData& effect)
+	{
+		ParseAdditionalEffectLevels(rootElement, effectId, effect);
+	});
+}
 
-			if (description == nullptr)
-				continue;
+void ParseSkill(const XmlTableFile& file)
+{
+	int skillId = file.Id;
+
+	parseTableFile(file, model().Skills[skillId], [skillId](auto rootElement, SkillData& skill)
+	{
+		ParseSkillLevels(rootElement, skillId, skill);
+	});
+}
+
+namespace
+{
+	template <typename Level>
+	bool keepLevelStrings(const std::unordered_map<int, Level>& previous, std::unordered_map<int, Level>& levels, const std::function<void(const Level& from, Level& to)>& copy)
+	{
+		bool complete = true;
+
+		for (auto& level : levels)
+		{
+			auto previousLevel = previous.find(level.first);
 
-			skillLevelIndex->second.Description = description->Value();
+			if (previousLevel == previous.end())
+				complete = false;
+			else
+				copy(previousLevel->second, level.second);
 		}
 
-		return;
+		return complete;
 	}
+}
+
+bool ReparseAdditionalEffect(const XmlTableFile& file)
+{
+	auto effectIndex = model().Effects.find(file.Id);
 
-	if (strcmp_s(fileName, "skillname") == 0)
+	bool existed = effectIndex != model().Effects.end();
+	AdditionalEffectData previous;
+
+	if (existed)
 	{
-		tinyxml2::XMLDocument document;
+		previous = std::move(effectIndex->second);
 
-		document.LoadFile(filePath.string().c_str());
+		model().Effects.erase(effectIndex);
+	}
 
-		tinyxml2::XMLElement* rootElement = document.RootElement();
+	if (!fs::exists(file.Path))
+		return true;
 
-		SupportSettings fileFeature;
-		SupportSettings fileLocale;
+	ParseAdditionalEffect(file);
 
-		if (!isNodeEnabled(rootElement, &fileFeature, &fileLocale))
-			return;
+	effectIndex = model().Effects.find(file.Id);
 
-		for (tinyxml2::XMLElement* keyElement = rootElement->FirstChildElement(); keyElement; keyElement = keyElement->NextSiblingElement())
-		{
-			SupportSettings keyFeature;
-			SupportSettings keyLocale;
+	if (effectIndex == model().Effects.end())
+		return true;
 
-			if (!isNodeEnabled(rootElement, &keyFeature, &keyLocale))
-				continue;
+	return existed && keepLevelStrings<AdditionalEffectLevelData>(previous.Levels, effectIndex->second.Levels, [](const AdditionalEffectLevelData& from, AdditionalEffectLevelData& to)
+	{
+		to.Name = from.Name;
+		to.Description = from.Description;
+	});
+}
 
-			int skillId = readAttribute<int>(keyElement, "id", 0);
+bool ReparseSkill(const XmlTableFile& file)
+{
+	auto skillIndex = model().Skills.find(file.Id);
 
-			auto skillIndex = skills.find(skillId);
+	bool existed = skillIndex != model().Skills.end();
+	SkillData previous;
 
-			if (skillIndex == skills.end())
-				continue;
+	if (existed)
+	{
+		previous = std::move(skillIndex->second);
 
-			SkillData& skill = skillIndex->second;
+		model().Skills.erase(skillIndex);
+	}
 
-			const tinyxml2::XMLAttribute* name = keyElement->FindAttribute("name");
+	if (!fs::exists(file.Path))
+		return true;
 
-			if (name == nullptr)
-				continue;
+	ParseSkill(file);
 
-			skill.Name = name->Value();
-		}
+	skillIndex = model().Skills.find(file.Id);
 
-		return;
-	}
+	if (skillIndex == model().Skills.end())
+		return true;
 
-	if (strcmp_s(fileName, "koradditionaldescription") == 0)
-	{
-		tinyxml2::XMLDocument document;
+	SkillData& skill = skillIndex->second;
 
-		document.LoadFile(filePath.string().c_str());
+	skill.Name = previous.Name;
 
-		tinyxml2::XMLElement* rootElement = document.RootElement();
+	return existed && keepLevelStrings<SkillLevelData>(previous.Levels, skill.Levels, [](const SkillLevelData& from, SkillLevelData& to)
+	{
+		to.Description = from.Description;
+	});
+}
 
-		SupportSettings fileFeature;
-		SupportSettings fileLocale;
+void ParseSkillDescriptionStrings(const fs::path& filePath)
+{
+	forEachRecord(filePath, true, [](const XmlStreamElement& keyElement)
+	{
+		int skillId = readAttribute<int>(keyElement, "id", 0);
 
-		if (!isNodeEnabled(rootElement, &fileFeature, &fileLocale))
-			return;
+		auto skillIndex = model().Skills.find(skillId);
 
-		for (tinyxml2::XMLElement* keyElement = rootElement->FirstChildElement(); keyElement; keyElement = keyElement->NextSiblingElement())
-		{
-			SupportSettings keyFeature;
-			SupportSettings keyLocale;
+		if (skillIndex == model().Skills.end())
+			return;
 
-			if (!isNodeEnabled(rootElement, &keyFeature, &keyLocale))
-				continue;
+		SkillData& skill = skillIndex->second;
 
-			int effectId = readAttribute<int>(keyElement, "id", 0);
+		int skillLevel = readAttribute<int>(keyElement, "level", 0);
 
-			auto effectIndex = effects.find(effectId);
+		auto skillLevelIndex = skill.Levels.find(skillLevel);
 
-			if (effectIndex == effects.end())
-				continue;
+		if (skillLevelIndex == skill.Levels.end())
+			return;
 
-			AdditionalEffectData& effect = effectIndex->second;
+		const char* description = keyElement.FindAttribute("uiDescription");
 
-			int effectLevel = readAttribute<int>(keyElement, "level", 0);
+		if (description == nullptr)
+			return;
 
-			auto effectLevelIndex = effect.Levels.find(effectLevel);
+		skillLevelIndex->second.Description = description;
+	});
+}
 
-			if (effectLevelIndex == effect.Levels.end())
-				continue;
+void ParseSkillNameStrings(const fs::path& filePath)
+{
+	forEachRecord(filePath, true, [](const XmlStreamElement& keyElement)
+	{
+		int skillId = readAttribute<int>(keyElement, "id", 0);
 
-			AdditionalEffectLevelData& level = effectLevelIndex->second;
+		auto skillIndex = model().Skills.find(skillId);
 
-			const tinyxml2::XMLAttribute* name = keyElement->FindAttribute("name");
+		if (skillIndex == model().Skills.end())
+			return;
 
-			if (name != nullptr)
-				level.Name = name->Value();
+		SkillData& skill = skillIndex->second;
 
-			const tinyxml2::XMLAttribute* description = keyElement->FindAttribute("tooltipDescription");
+		const char* name = keyElement.FindAttribute("name");
 
-			if (description != nullptr)
-				level.Description = description->Value();
-		}
+		if (name == nullptr)
+			return;
 
-		return;
-	}
+		skill.Name = name;
+	});
 }
 
-void ParseJobs(const fs::path& filePath)
+void ParseEffectStrings(const fs::path& filePath)
 {
-	tinyxml2::XMLDocument document;
+	forEachRecord(filePath, true, [](const XmlStreamElement& keyElement)
+	{
+		int effectId = readAttribute<int>(keyElement, "id", 0);
 
-	document.LoadFile(filePath.string().c_str());
+		auto effectIndex = model().Effects.find(effectId);
 
-	tinyxml2::XMLElement* rootElement = document.RootElement();
+		if (effectIndex == model().Effects.end())
+			return;
 
-	SupportSettings fileFeature;
-	SupportSettings fileLocale;
+		AdditionalEffectData& effect = effectIndex->second;
 
-	if (!isNodeEnabled(rootElement, &fileFeature, &fileLocale))
-		return;
+		int effectLevel = readAttribute<int>(keyElement, "level", 0);
+
+		auto effectLevelIndex = effect.Levels.find(effectLevel);
+
+		if (effectLevelIndex == effect.Levels.end())
+			return;
+
+		AdditionalEffectLevelData& level = effectLevelIndex->second;
+
+		const char* name = keyElement.FindAttribute("name");
 
-	for (tinyxml2::XMLElement* jobElement = rootElement->FirstChildElement(); jobElement; jobElement = jobElement->NextSiblingElement())
+		if (name != nullptr)
+			level.Name = name;
+
+		const char* description = keyElement.FindAttribute("tooltipDescription");
+
+		if (description != nullptr)
+			level.Description = description;
+	});
+}
+
+void ParseJobs(const fs::path& filePath)
+{
+	forEachRecordElement(filePath, true, [](tinyxml2::XMLElement* jobElement)
 	{
 		SupportSettings jobFeature;
 		SupportSettings jobLocale;
 
 		if (!isNodeEnabled(jobElement, &jobFeature, &jobLocale))
-			continue;
+			return;
 
 		JobCode jobCode = (JobCode)readAttribute<int>(jobElement, "code", 0);
 
 		if (jobCode == JobCode::None)
-			continue;
+			return;
 
-		JobData& job = jobs[jobCode];
+		JobData& job = model().Jobs[jobCode];
 
 		if (!isNodeEnabled(jobElement, &job.Feature, &job.Locale))
-			continue;
+			return;
 
 		job = JobData(job.Feature, job.Locale);
 		job.Job = jobCode;
@@ -776,7 +863,7 @@ void ParseJobs(const fs::path& filePath)
 		tinyxml2::XMLElement* skillsElement = jobElement->FirstChildElement("skills");
 
 		if (skillsElement == nullptr)
-			continue;
+			return;
 
 		for (tinyxml2::XMLElement* skillElement = skillsElement->FirstChildElement(); skillElement; skillElement = skillElement->NextSiblingElement())
 		{
@@ -795,72 +882,67 @@ void ParseJobs(const fs::path& filePath)
 			for (int i = 0; i < subSkills.size(); ++i)
 				skill.SubSkills.push_back(ReferenceData{ ReferenceType::Skill, subSkills[i], 0 });
 		}
-	}
+	});
 }
 
 void ParseJobStrings(const fs::path& filePath)
 {
-	tinyxml2::XMLDocument document;
-
-	document.LoadFile(filePath.string().c_str());
-
-	tinyxml2::XMLElement* rootElement = document.RootElement();
-
-	SupportSettings fileFeature;
-	SupportSettings fileLocale;
-
-	if (!isNodeEnabled(rootElement, &fileFeature, &fileLocale))
-		return;
-
-	for (tinyxml2::XMLElement* jobElement = rootElement->FirstChildElement(); jobElement; jobElement = jobElement->NextSiblingElement())
+	forEachRecord(filePath, true, [](const XmlStreamElement& jobElement)
 	{
 		SupportSettings jobFeature;
 		SupportSettings jobLocale;
 
 		if (!isNodeEnabled(jobElement, &jobFeature, &jobLocale))
-			continue;
+			return;
 
 		int jobCodeValue = readAttribute<int>(jobElement, "id", 0);
 		int jobCodeRawValue = jobCodeValue / 10;
 		JobCode jobCode = (JobCode)jobCodeRawValue;
 
-		auto jobIndex = jobs.find(jobCode);
+		auto jobIndex = model().Jobs.find(jobCode);
 
 		bool isAwakening = jobCodeValue != 10 * jobCodeRawValue;
 
-		if (jobIndex == jobs.end())
-			continue;
+		if (jobIndex == model().Jobs.end())
+			return;
 
 		JobData& job = jobIndex->second;
 
-		const tinyxml2::XMLAttribute* nameAttribute = jobElement->FindAttribute("name");
+		const char* nameAttribute = jobElement.FindAttribute("name");
 
 		if (nameAttribute == nullptr)
-			continue;
+			return;
 
 		if (isAwakening)
-			job.AwakenedName = nameAttribute->Value();
+			job.AwakenedName = nameAttribute;
 		else
-			job.Name = nameAttribute->Value();
-	}
+			job.Name = nameAttribute;
+	});
 }
 
-void ParseSetBonusOptions(const fs::path& filePath)
+struct SetBonusPartRecord
 {
-	tinyxml2::XMLDocument document;
+	int Count = 0;
+	std::vector<int> EffectIds;
+	std::vector<int> EffectLevels;
+};
 
-	document.LoadFile(filePath.string().c_str());
+constexpr auto setBonusPartSchema = schema(
+	schemaField("count", &SetBonusPartRecord::Count, 0),
+	schemaField("additionalEffectID", &SetBonusPartRecord::EffectIds),
+	schemaField("additionalEffectLevel", &SetBonusPartRecord::EffectLevels)
+);
 
-	tinyxml2::XMLElement* rootElement = document.RootElement();
-
-	for (tinyxml2::XMLElement* optionElement = rootElement->FirstChildElement(); optionElement; optionElement = optionElement->NextSiblingElement())
+void ParseSetBonusOptions(const fs::path& filePath)
+{
+	forEachRecordElement(filePath, false, [](tinyxml2::XMLElement* optionElement)
 	{
 		int optionId = readAttribute<int>(optionElement, "id", 0);
 
 		if (optionId == 0)
-			continue;
+			return;
 
-		SetBonusOptionData& optionData = setBonusOptions[optionId];
+		SetBonusOptionData& optionData = model().SetBonusOptions[optionId];
 
 		for (tinyxml2::XMLElement* partElement = optionElement->FirstChildElement(); partElement; partElement = partElement->NextSiblingElement())
 		{
@@ -868,52 +950,44 @@ void ParseSetBonusOptions(const fs::path& filePath)
 
 			SetBonusOptionPartData& partData = optionData.Parts.back();
 
-			partData.Count = readAttribute<int>(partElement, "count", 0);
+			SetBonusPartRecord part;
 
-			std::vector<int> effectIds;
-			std::vector<int> effectLevels;
+			readSchema(partElement, part, setBonusPartSchema);
 
-			readAttribute(partElement, "additionalEffectID", effectIds);
-			readAttribute(partElement, "additionalEffectLevel", effectLevels);
+			partData.Count = part.Count;
 
-			for (int i = 0; i < effectIds.size(); ++i)
-				if (effectIds[i] != 0)
-					partData.AdditionalEffects.push_back(ReferenceData{ ReferenceType::Effect, effectIds[i], effectLevels[i] });
+			for (int i = 0; i < part.EffectIds.size(); ++i)
+				if (part.EffectIds[i] != 0)
+					partData.AdditionalEffects.push_back(ReferenceData{ ReferenceType::Effect, part.EffectIds[i], part.EffectLevels[i] });
 		}
-	}
+	});
 }
 
 void ParseSetBonuses(const fs::path& filePath)
 {
-	tinyxml2::XMLDocument document;
-
-	document.LoadFile(filePath.string().c_str());
-
-	tinyxml2::XMLElement* rootElement = document.RootElement();
-
-	for (tinyxml2::XMLElement* setElement = rootElement->FirstChildElement(); setElement; setElement = setElement->NextSiblingElement())
+	forEachRecordElement(filePath, false, [](tinyxml2::XMLElement* setElement)
 	{
 		SupportSettings setFeature;
 		SupportSettings setLocale;
 
 		if (!isNodeEnabled(setElement, &setFeature, &setLocale))
-			continue;
+			return;
 
 		int setId = readAttribute<int>(setElement, "id", 0);
 		int optionId = readAttribute<int>(setElement, "optionID", 0);
 
 		if (setId == 0 || optionId == 0)
-			continue;
+			return;
 
-		const auto optionIndex = setBonusOptions.find(optionId);
+		const auto optionIndex = model().SetBonusOptions.find(optionId);
 
-		if (optionIndex == setBonusOptions.end())
-			continue;
+		if (optionIndex == model().SetBonusOptions.end())
+			return;
 
-		SetBonusData& setData = setBonuses[setId];
+		SetBonusData& setData = model().SetBonuses[setId];
 
 		if (!isNodeEnabled(setElement, &setData.Feature, &setData.Locale))
-			continue;
+			return;
 
 		setData = SetBonusData(setData.Feature, setData.Locale);
 
@@ -921,38 +995,32 @@ void ParseSetBonuses(const fs::path& filePath)
 		setData.OptionData = &optionIndex->second;
 
 		readAttribute(setElement, "itemIDs", setData.ItemIds);
-	}
+	});
 }
 
 void ParseSetBonusStrings(const fs::path& filePath)
 {
-	tinyxml2::XMLDocument document;
-
-	document.LoadFile(filePath.string().c_str());
-
-	tinyxml2::XMLElement* rootElement = document.RootElement();
-
-	for (tinyxml2::XMLElement* keyElement = rootElement->FirstChildElement(); keyElement; keyElement = keyElement->NextSiblingElement())
+	forEachRecord(filePath, false, [](const XmlStreamElement& keyElement)
 	{
 		int setId = readAttribute<int>(keyElement, "id", 0);
 
-		const auto setIndex = setBonuses.find(setId);
+		const auto setIndex = model().SetBonuses.find(setId);
 
-		if (setIndex == setBonuses.end())
-			continue;
+		if (setIndex == model().SetBonuses.end())
+			return;
 
 		SetBonusData& setData = setIndex->second;
 
 		if (!isNodeEnabled(keyElement, &setData.Feature, &setData.Locale))
-			continue;
+			return;
 
-		const tinyxml2::XMLAttribute* nameAttribute = keyElement->FindAttribute("name");
+		const char* nameAttribute = keyElement.FindAttribute("name");
 
 		if (nameAttribute == nullptr)
-			continue;
+			return;
 
-		setData.Name = nameAttribute->Value();
-	}
+		setData.Name = nameAttribute;
+	});
 }
 
 ItemType GetItemType(int idDigits)
@@ -999,261 +1067,425 @@ ItemType GetItemType(int idDigits)
 	}
 }
 
-void ParseItems(const fs::path& filePath)
+// only the first limit, AdditionalEffect and skill element of each environment are read, everything else is skipped unparsed
+struct ItemEnvironment
+{
+	bool Enabled = false;
+	bool HasLimit = false;
+	bool HasEffects = false;
+	bool HasSkills = false;
+	JobCode JobLimit = JobCode::None;
+	std::vector<int> EffectIds;
+	std::vector<int> EffectLevels;
+	std::vector<int> SkillIds;
+	std::vector<int> SkillLevels;
+};
+
+constexpr auto itemLimitSchema = schema(
+	schemaField("jobLimit", &ItemEnvironment::JobLimit, JobCode::None)
+);
+
+constexpr auto itemEffectSchema = schema(
+	schemaField("id", &ItemEnvironment::EffectIds),
+	schemaField("level", &ItemEnvironment::EffectLevels)
+);
+
+constexpr auto itemSkillSchema = schema(
+	schemaField("skillID", &ItemEnvironment::SkillIds),
+	schemaField("skillLevel", &ItemEnvironment::SkillLevels)
+);
+
+bool ItemFilterSettings::Keeps(int itemId) const
 {
-	int itemId = atoi(filePath.stem().string().c_str());
+	if (!Enabled || KeepIds.contains(itemId))
+		return true;
 
-	ItemData& item = items[itemId];
+	int idDigits = itemId / 100000;
 
-	tinyxml2::XMLDocument document;
+	if (KeepPrefixes.size() > 0)
+		return KeepPrefixes.contains(idDigits);
 
-	document.LoadFile(filePath.string().c_str());
+	ItemType type = GetItemType(idDigits);
 
-	tinyxml2::XMLElement* rootElement = document.RootElement();
+	return type == ItemType::Lapenshard || type == ItemType::Medal || (type >= ItemType::Earring && type <= ItemType::Orb);
+}
 
-	for (tinyxml2::XMLElement* environmentElement = rootElement->FirstChildElement(); environmentElement; environmentElement = environmentElement->NextSiblingElement())
+void ParseItems(const XmlTableFile& file)
+{
+	int itemId = file.Id;
+
+	if (!itemFilter.Keeps(itemId))
 	{
-		if (!isNodeEnabled(environmentElement, &item.Feature, &item.Locale))
-			continue;
+		++ingestStats.SkippedItemFiles;
+		ingestStats.SkippedItemBytes += (long long)file.Size;
+
+		return;
+	}
+
+	++ingestStats.ParsedItemFiles;
+
+	ItemData& item = model().Items[itemId];
+
+	XmlSourceFile sourceFile;
+
+	if (!sourceFile.Open(file))
+		return;
+
+	XmlStreamReader reader;
+
+	reader.Open(sourceFile.GetText());
+
+	if (!reader.NextElement())
+		return;
+
+	ItemEnvironment environment;
+
+	const auto finishEnvironment = [&item, &environment, itemId]()
+	{
+		if (!environment.Enabled)
+			return;
 
 		item = ItemData(item.Feature, item.Locale);
 
 		item.Id = itemId;
 		item.Type = GetItemType(itemId / 100000);
 
-		tinyxml2::XMLElement* limit = environmentElement->FirstChildElement("limit");
-		tinyxml2::XMLElement* additionalEffects = environmentElement->FirstChildElement("AdditionalEffect");
-		tinyxml2::XMLElement* skills = environmentElement->FirstChildElement("skill");
-
-		if (limit != nullptr)
-			item.JobLimit = (JobCode)readAttribute<int>(limit, "jobLimit", 0);
+		if (environment.HasLimit)
+			item.JobLimit = environment.JobLimit;
 
 		if (item.Type == ItemType::Lapenshard)
 		{
 			if (item.JobLimit != JobCode::None)
-				jobs[item.JobLimit].Lapenshards.push_back(&item);
+				model().Jobs[item.JobLimit].Lapenshards.push_back(&item);
 			else
-				for (auto& jobPair : jobs)
+				for (auto& jobPair : model().Jobs)
 					jobPair.second.Lapenshards.push_back(&item);
 		}
 
-		std::vector<int> referenceIds;
-		std::vector<int> referenceLevels;
+		for (int i = 0; i < environment.EffectIds.size(); ++i)
+		{
+			int effectId = environment.EffectIds[i];
 
-		if (additionalEffects != nullptr)
+			if (effectId == 0)
+				continue;
+
+			item.AdditionalEffects.push_back(ReferenceData{ ReferenceType::Effect, effectId, environment.EffectLevels[i] });
+		}
+
+		for (int i = 0; i < environment.SkillIds.size(); ++i)
 		{
-			readAttribute(additionalEffects, "id", referenceIds);
-			readAttribute(additionalEffects, "level", referenceLevels);
+			int skillId = environment.SkillIds[i];
 
-			for (int i = 0; i < referenceIds.size(); ++i)
-			{
-				int effectId = referenceIds[i];
+			if (skillId == 0)
+				continue;
 
-				if (effectId == 0)
-					continue;
+			item.Skills.push_back(ReferenceData{ ReferenceType::Skill, skillId, environment.SkillLevels[i] });
+		}
+	};
 
-				item.AdditionalEffects.push_back(ReferenceData{ ReferenceType::Effect, effectId, referenceLevels[i] });
+	while (reader.NextElement())
+	{
+		const XmlStreamElement& element = reader.GetElement();
+
+		if (element.Depth == 1)
+		{
+			finishEnvironment();
+
+			environment = ItemEnvironment();
+			environment.Enabled = isNodeEnabled(element, &item.Feature, &item.Locale);
+
+			if (!environment.Enabled)
+			{
+				++ingestStats.SkippedItemEnvironments;
+
+				reader.SkipChildren();
 			}
+
+			continue;
 		}
 
-		referenceIds.clear();
-		referenceLevels.clear();
+		if (element.Depth != 2 || !environment.Enabled)
+			continue;
+
+		uint64_t elementHash = schemaHash(element.Name);
 
-		if (skills != nullptr)
+		if (!environment.HasLimit && elementHash == schemaName("limit"))
 		{
-			readAttribute(skills, "skillID", referenceIds);
-			readAttribute(skills, "skillLevel", referenceLevels);
+			environment.HasLimit = true;
 
-			for (int i = 0; i < referenceIds.size(); ++i)
-			{
-				int effectId = referenceIds[i];
+			readSchema(element, environment, itemLimitSchema);
+		}
+		else if (!environment.HasEffects && elementHash == schemaName("AdditionalEffect"))
+		{
+			environment.HasEffects = true;
 
-				if (effectId == 0)
-					continue;
+			readSchema(element, environment, itemEffectSchema);
+		}
+		else if (!environment.HasSkills && elementHash == schemaName("skill"))
+		{
+			environment.HasSkills = true;
 
-				item.Skills.push_back(ReferenceData{ ReferenceType::Skill, effectId, referenceLevels[i] });
-			}
+			readSchema(element, environment, itemSkillSchema);
 		}
 	}
+
+	finishEnvironment();
 }
 
-void ParseItemStrings(const fs::path& filePath)
+bool ReparseItem(const XmlTableFile& file)
 {
-	tinyxml2::XMLDocument document;
+	auto itemIndex = model().Items.find(file.Id);
 
-	document.LoadFile(filePath.string().c_str());
+	bool existed = itemIndex != model().Items.end();
+	ItemData previous;
 
-	tinyxml2::XMLElement* rootElement = document.RootElement();
+	// a lapenshard goes back where it was in each job's list, so the kit prints it in the same place
+	std::unordered_map<JobCode, size_t> lapenshardIndices;
 
-	for (tinyxml2::XMLElement* keyElement = rootElement->FirstChildElement(); keyElement; keyElement = keyElement->NextSiblingElement())
+	if (existed)
+	{
+		ItemData* item = &itemIndex->second;
+
+		for (auto& jobPair : model().Jobs)
+		{
+			std::vector<ItemData*>& lapenshards = jobPair.second.Lapenshards;
+
+			auto lapenshard = std::find(lapenshards.begin(), lapenshards.end(), item);
+
+			if (lapenshard == lapenshards.end())
+				continue;
+
+			lapenshardIndices[jobPair.first] = lapenshard - lapenshards.begin();
+
+			lapenshards.erase(lapenshard);
+		}
+
+		previous = std::move(*item);
+
+		model().Items.erase(itemIndex);
+	}
+
+	if (!fs::exists(file.Path))
+		return true;
+
+	ParseItems(file);
+
+	itemIndex = model().Items.find(file.Id);
+
+	if (itemIndex == model().Items.end())
+		return true;
+
+	for (auto& jobPair : model().Jobs)
+	{
+		std::vector<ItemData*>& lapenshards = jobPair.second.Lapenshards;
+		auto lapenshardIndex = lapenshardIndices.find(jobPair.first);
+
+		if (lapenshardIndex == lapenshardIndices.end() || lapenshards.size() == 0 || lapenshards.back() != &itemIndex->second)
+			continue;
+
+		std::rotate(lapenshards.begin() + std::min(lapenshardIndex->second, lapenshards.size() - 1), lapenshards.end() - 1, lapenshards.end());
+	}
+
+	itemIndex->second.Name = previous.Name;
+	itemIndex->second.Class = previous.Class;
+	itemIndex->second.Description = previous.Description;
+
+	return existed;
+}
+
+void ParseItemStrings(const fs::path& filePath)
+{
+	forEachRecord(filePath, false, [](const XmlStreamElement& keyElement)
 	{
 		int itemId = readAttribute<int>(keyElement, "id", 0);
 
 		if (itemId == 0)
-			continue;
+			return;
 
-		auto itemIndex = items.find(itemId);
+		auto itemIndex = model().Items.find(itemId);
 
-		if (itemIndex == items.end())
-			continue;
+		if (itemIndex == model().Items.end())
+			return;
 
 		ItemData& item = itemIndex->second;
 
 		if (!isNodeEnabled(keyElement, &item.Feature, &item.Locale))
-			continue;
+			return;
 
-		const tinyxml2::XMLAttribute* nameAttribute = keyElement->FindAttribute("name");
+		const char* nameAttribute = keyElement.FindAttribute("name");
 
 		if (nameAttribute == nullptr)
-			continue;
+			return;
 
-		item.Name = nameAttribute->Value();
+		item.Name = nameAttribute;
 
-		const tinyxml2::XMLAttribute* classAttribute = keyElement->FindAttribute("class");
+		const char* classAttribute = keyElement.FindAttribute("class");
 
 		if (classAttribute == nullptr)
-			continue;
+			return;
 
-		item.Class = classAttribute->Value();
-	}
+		item.Class = classAttribute;
+	});
 }
 
 void ParseItemDescriptionStrings(const fs::path& filePath)
 {
-	tinyxml2::XMLDocument document;
-
-	document.LoadFile(filePath.string().c_str());
-
-	tinyxml2::XMLElement* rootElement = document.RootElement();
-
-	for (tinyxml2::XMLElement* keyElement = rootElement->FirstChildElement(); keyElement; keyElement = keyElement->NextSiblingElement())
+	forEachRecord(filePath, false, [](const XmlStreamElement& keyElement)
 	{
 		int itemId = readAttribute<int>(keyElement, "id", 0);
 
 		if (itemId == 0)
-			continue;
+			return;
 
-		auto itemIndex = items.find(itemId);
+		auto itemIndex = model().Items.find(itemId);
 
-		if (itemIndex == items.end())
-			continue;
+		if (itemIndex == model().Items.end())
+			return;
 
 		ItemData& item = itemIndex->second;
 
 		if (!isNodeEnabled(keyElement, &item.Feature, &item.Locale))
-			continue;
+			return;
 
-		const tinyxml2::XMLAttribute* tooltipAttribute = keyElement->FindAttribute("tooltipDescription");
+		const char* tooltipAttribute = keyElement.FindAttribute("tooltipDescription");
 
 		if (tooltipAttribute == nullptr)
-			continue;
+			return;
 
-		item.Description = tooltipAttribute->Value();
+		item.Description = tooltipAttribute;
 
-		const tinyxml2::XMLAttribute* guideAttribute = keyElement->FindAttribute("guideDescription");
+		const char* guideAttribute = keyElement.FindAttribute("guideDescription");
 
 		if (guideAttribute == nullptr)
-			continue;
+			return;
 
-		item.Description += guideAttribute->Value();
-	}
+		item.Description += guideAttribute;
+	});
 }
 
-std::string Sanitize(const std::string& text, bool isTooltip)
+namespace
 {
-	int extraCharacters = 0;
-
-	for (int i = 0; i < text.size(); ++i)
-	{
-		if (text[i] == '"' || text[i] == '\\')
-			++extraCharacters;
-		else if (text[i] == '\n' || text[i] == '\r')
-			extraCharacters += isTooltip ? 5 : 1;
-	}
+	// 1 for quotes and backslashes, 2 for line breaks
+	const auto sanitizeClasses = ([]()
+		{
+			std::array<unsigned char, 256> classes = { 0 };
 
-	if (extraCharacters == 0)
-		return text;
+			classes['"'] = 1;
+			classes['\\'] = 1;
+			classes['\n'] = 2;
+			classes['\r'] = 2;
 
-	std::string cleaned;
+			return classes;
+		}
+	)();
+}
 
-	cleaned.reserve(text.size() + extraCharacters);
+void appendSanitized(std::string& output, std::string_view text, bool isTooltip)
+{
+	size_t runStart = 0;
 
-	for (int i = 0; i < text.size(); ++i)
+	for (size_t i = 0; i < text.size(); ++i)
 	{
-		if (text[i] == '"' || text[i] == '\\')
-			cleaned.push_back('\\');
+		unsigned char characterClass = sanitizeClasses[(unsigned char)text[i]];
 
-		if (text[i] != '\n' && text[i] != '\r')
-			cleaned.push_back(text[i]);
-		else if (!isTooltip)
-			cleaned.push_back(text[i] == '\n' ? 'n' : 'r');
-		else
+		if (characterClass == 0)
+			continue;
+
+		output.append(text.data() + runStart, i - runStart);
+
+		runStart = i + 1;
+
+		if (characterClass == 1)
 		{
-			cleaned.push_back('&');
-			cleaned.push_back('#');
-			cleaned.push_back('0');
-			cleaned.push_back('1');
-			cleaned.push_back('3');
-			cleaned.push_back(';');
+			output.push_back('\\');
+			output.push_back(text[i]);
 		}
+		// CRLF and a lone CR are one line break each. \r is a line break of its own in DOT, so it is never written
+		else if (text[i] == '\r' && i + 1 < text.size() && text[i + 1] == '\n')
+			continue;
+		else if (isTooltip)
+			output.append("&#013;");
+		else
+			output.append("\\n");
 	}
 
+	output.append(text.data() + runStart, text.size() - runStart);
+}
+
+std::string Sanitize(const std::string& text, bool isTooltip)
+{
+	std::string cleaned;
+
+	cleaned.reserve(text.size() + 16);
+
+	appendSanitized(cleaned, text, isTooltip);
+
 	return cleaned;
 }
 
 std::string Desanitize(const std::string& text)
 {
-	int apostrophies = 0;
-	int specialCharacterStart = -1;
-	int specialCharacterLength = 0;
+	std::string cleaned;
 
-	for (int i = 0; i < text.size(); ++i)
-	{
-		if (text[i] == '&')
-		{
-			specialCharacterStart = i;
-			specialCharacterLength = 0;
-		}
+	cleaned.reserve(text.size());
 
-		if (text[i] == ';' && specialCharacterStart != -1 && specialCharacterLength == 0)
-		{
-			specialCharacterLength = i - specialCharacterStart;
+	size_t runStart = 0;
 
-			if (strncmp(text.c_str() + specialCharacterStart, "&apos;", std::min(specialCharacterLength, 6)) == 0)
-				++apostrophies;
-		}
+	for (size_t i = text.find("&apos;"); i != std::string::npos; i = text.find("&apos;", runStart))
+	{
+		cleaned.append(text, runStart, i - runStart);
+		cleaned.push_back('\'');
+
+		runStart = i + 6;
 	}
 
-	if (apostrophies == 0)
-		return text;
+	cleaned.append(text, runStart, std::string::npos);
 
-	std::string cleaned;
+	return cleaned;
+}
 
-	cleaned.resize(text.size() - 5 * apostrophies);
+PooledString poolLabel(const std::string& text, bool isTooltip)
+{
+	PooledString pooled;
 
-	int textIndex = 0;
+	pooled.Offset = (unsigned int)model().LabelPool.size();
 
-	for (int i = 0; i < text.size(); ++i)
-	{
-		if (text[i] == '&')
-		{
-			specialCharacterStart = i;
-			specialCharacterLength = 0;
-		}
+	appendSanitized(model().LabelPool, text, isTooltip);
 
-		if (specialCharacterStart == -1)
-			cleaned[textIndex++] = text[i];
+	pooled.Length = (unsigned int)model().LabelPool.size() - pooled.Offset;
 
-		if (text[i] == ';' && specialCharacterStart != -1 && specialCharacterLength == 0)
-		{
-			specialCharacterLength = i - specialCharacterStart;
+	return pooled;
+}
+
+std::string_view getPooledLabel(const PooledString& text)
+{
+	return std::string_view(model().LabelPool.data() + text.Offset, text.Length);
+}
 
-			if (strncmp(text.c_str() + specialCharacterStart, "&apos;", std::min(specialCharacterLength, 6)) == 0)
-				cleaned[textIndex++] = '\'';
+void poolLabels()
+{
+	model().LabelPool.clear();
+
+	for (auto& skill : model().Skills)
+	{
+		skill.second.EscapedName = poolLabel(skill.second.Name);
+
+		for (auto& level : skill.second.Levels)
+			level.second.EscapedDescription = poolLabel(level.second.Description, true);
+	}
 
-			specialCharacterStart = -1;
+	for (auto& effect : model().Effects)
+	{
+		for (auto& level : effect.second.Levels)
+		{
+			level.second.EscapedName = poolLabel(level.second.Name);
+			level.second.EscapedDescription = poolLabel(level.second.Description, true);
 		}
 	}
 
-	return cleaned;
+	for (auto& item : model().Items)
+	{
+		item.second.EscapedName = poolLabel(item.second.Name);
+		item.second.EscapedDescription = poolLabel(item.second.Description, true);
+	}
 }
\ No newline at end of file
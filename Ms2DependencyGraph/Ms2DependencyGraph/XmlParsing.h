@@ -1,31 +1,80 @@
 #pragma once
 
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <filesystem>
 
 #include "tinyxml2.h"
 #include "ParserUtils.h"
+#include "XmlSource.h"
 #include "XmlData.h"
 
-extern std::unordered_map<int, MagicPathData> magicPaths;
-extern std::unordered_map<int, AdditionalEffectData> effects;
-extern std::unordered_map<int, SkillData> skills;
-extern std::unordered_map<JobCode, JobData> jobs;
-extern std::unordered_map<int, SetBonusOptionData> setBonusOptions;
-extern std::unordered_map<int, SetBonusData> setBonuses;
-extern std::unordered_map<int, ItemData> items;
+// Everything loaded from the game data. The parsers fill and the printers read whichever model model() returns.
+struct GraphModel
+{
+	std::unordered_map<int, MagicPathData> MagicPaths;
+	std::unordered_map<int, AdditionalEffectData> Effects;
+	std::unordered_map<int, SkillData> Skills;
+	std::unordered_map<JobCode, JobData> Jobs;
+	std::unordered_map<int, SetBonusOptionData> SetBonusOptions;
+	std::unordered_map<int, SetBonusData> SetBonuses;
+	std::unordered_map<int, ItemData> Items;
+	std::string LabelPool;
+};
+
+// The model being loaded, which every thread reads unless it has one of its own. A daemon gives each query thread the
+// snapshot it took, so a reload can fill a new shared model without the queries seeing it half built.
+extern GraphModel* sharedModel;
+extern thread_local GraphModel* threadModel;
+
+inline GraphModel& model() { return threadModel != nullptr ? *threadModel : *sharedModel; }
+
+// Decides from the file name alone whether an item file is worth opening.
+struct ItemFilterSettings
+{
+	bool Enabled = true;
+
+	// id / 100000 ranges to keep. Empty keeps the equipment, medal and lapenshard ranges.
+	std::unordered_set<int> KeepPrefixes;
+
+	// items that are needed whatever their range, such as set pieces
+	std::unordered_set<int> KeepIds;
+
+	bool Keeps(int itemId) const;
+};
+
+extern ItemFilterSettings itemFilter;
+
+// Which DOM parser reads the skill and effect files. Verify runs both and reports files where the models differ.
+enum class XmlParserMode
+{
+	Tinyxml2,
+	InSitu,
+	Verify
+};
+
+extern XmlParserMode xmlParserMode;
 
 void ParseMagicPaths(const fs::path& filePath);
 
-void ParseBeginCondition(tinyxml2::XMLElement* node, BeginCondition& condition);
-void ParseConditionSkill(tinyxml2::XMLElement* node, ConditionSkill& conditionSkill);
 
-void ParseAdditionalEffect(const fs::path& filePath);
-void ParseSkill(const fs::path& filePath);
-void ParseStrings(const fs::path& filePath);
-void ParseItems(const fs::path& filePath);
+void ParseAdditionalEffect(const XmlTableFile& file);
+void ParseSkill(const XmlTableFile& file);
+void ParseSkillDescriptionStrings(const fs::path& filePath);
+void ParseSkillNameStrings(const fs::path& filePath);
+void ParseEffectStrings(const fs::path& filePath);
+void ParseItems(const XmlTableFile& file);
+
+// Parse one changed skill, effect or item file again in place of what it loaded before, or drop its entry when the file
+// is gone. Strings the tables gave the old entry are kept; false means the file added an id or level they were never
+// read for, so the string tables need loading again.
+bool ReparseAdditionalEffect(const XmlTableFile& file);
+bool ReparseSkill(const XmlTableFile& file);
+bool ReparseItem(const XmlTableFile& file);
+ItemType GetItemType(int idDigits);
 void ParseItemStrings(const fs::path& filePath);
 void ParseItemDescriptionStrings(const fs::path& filePath);
 void ParseJobs(const fs::path& filePath);
@@ -34,4 +83,10 @@ void ParseSetBonusOptions(const fs::path& filePath);
 void ParseSetBonuses(const fs::path& filePath);
 void ParseSetBonusStrings(const fs::path& filePath);
 std::string Desanitize(const std::string& text);
-std::string Sanitize(const std::string& text, bool isTooltip = false);
\ No newline at end of file
+std::string Sanitize(const std::string& text, bool isTooltip = false);
+void appendSanitized(std::string& output, std::string_view text, bool isTooltip = false);
+PooledString poolLabel(const std::string& text, bool isTooltip = false);
+std::string_view getPooledLabel(const PooledString& text);
+
+// Escapes every skill, effect and item name and description into the model's LabelPool. Run once the string tables load.
+void poolLabels();
\ No newline at end of file
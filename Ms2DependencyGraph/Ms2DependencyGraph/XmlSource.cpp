@@ -0,0 +1,119 @@
+#include "XmlSource.h"
+
+#include "ParserUtils.h"
+#include "FilePrefetch.h"
+
+XmlArchive xmlArchive;
+FileManifest fileManifest;
+
+bool XmlSourceFile::Open(const fs::path& filePath)
+{
+	Text = std::string_view();
+
+	if (!xmlArchive.IsOpen())
+	{
+		if (!File.Open(filePath))
+			return false;
+
+		Text = File.GetText();
+
+		return true;
+	}
+
+	const XmlArchiveEntry* entry = xmlArchive.Find(filePath.generic_string());
+
+	if (entry == nullptr)
+		return false;
+
+	Text = xmlArchive.GetData(*entry);
+
+	return Text.size() == entry->Size;
+}
+
+bool XmlSourceFile::Open(const XmlTableFile& file)
+{
+	if (file.Text.data() == nullptr)
+		return Open(file.Path);
+
+	Text = file.Text;
+
+	return true;
+}
+
+uintmax_t getXmlFileSize(const fs::path& filePath)
+{
+	if (xmlArchive.IsOpen())
+	{
+		const XmlArchiveEntry* entry = xmlArchive.Find(filePath.generic_string());
+
+		return entry != nullptr ? entry->Size : 0;
+	}
+
+	std::error_code error;
+	uintmax_t fileSize = fs::file_size(filePath, error);
+
+	return error ? 0 : fileSize;
+}
+
+void forEachXmlFile(const fs::path& root, bool recursiveSearch, const std::function<void(const fs::path&)>& callback)
+{
+	if (!xmlArchive.IsOpen())
+	{
+		forEachFile(root, recursiveSearch, callback);
+
+		return;
+	}
+
+	xmlArchive.ForEach(root.generic_string(), recursiveSearch, [&callback](const XmlArchiveEntry& entry)
+	{
+		callback(fs::path(xmlArchive.GetPath(entry)));
+	});
+}
+
+void forEachTableFile(const fs::path& root, const std::function<void(const XmlTableFile&)>& callback, const std::function<bool(const XmlTableFile&)>& wanted)
+{
+	XmlTableFile file;
+
+	if (xmlArchive.IsOpen())
+	{
+		xmlArchive.ForEach(root.generic_string(), true, [&callback, &file](const XmlArchiveEntry& entry)
+		{
+			std::string_view path = xmlArchive.GetPath(entry);
+
+			file.Path = path;
+			file.Id = readFileId(path.substr(path.rfind('/') + 1));
+			file.Size = entry.Size;
+
+			callback(file);
+		});
+
+		return;
+	}
+
+	std::vector<XmlTableFile> files;
+
+	if (fileManifest.HasRoot(root))
+	{
+		fileManifest.ForEach(root, [&files, &file](const FileManifestEntry& entry, const fs::path& filePath)
+		{
+			file.Path = filePath;
+			file.Id = entry.Id;
+			file.Size = entry.Size;
+
+			files.push_back(file);
+		});
+	}
+	else
+	{
+		forEachFile(root, true, [&files, &file](const fs::path& filePath)
+		{
+			file.Path = filePath;
+			file.Id = readFileId(filePath.filename().string());
+			file.Size = getXmlFileSize(filePath);
+
+			files.push_back(file);
+		});
+	}
+
+	prefetchFiles(root.parent_path().filename().string(), files, wanted, callback);
+}
\ No newline at end of file
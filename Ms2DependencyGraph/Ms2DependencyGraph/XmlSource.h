@@ -0,0 +1,50 @@
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <string_view>
+
+#include "MappedFile.h"
+#include "XmlArchive.h"
+#include "FileManifest.h"
+
+namespace fs = std::filesystem;
+
+// Game XML is read from the extracted tree, or from xmlArchive, a repacked copy of it, once that is open. The loaders
+// build their paths the same way for both; with an archive the paths are relative to its root.
+extern XmlArchive xmlArchive;
+
+// Listing of the table roots on disk. Roots it doesn't have are walked directly.
+extern FileManifest fileManifest;
+
+// A file under one of the table roots, with the id its name starts with and its size. Text holds the contents when
+// they were read ahead of the parser, otherwise it is null and the file is opened from Path.
+struct XmlTableFile
+{
+	fs::path Path;
+	int Id = 0;
+	uint64_t Size = 0;
+	std::string_view Text;
+};
+
+// One file from the active source, mapped from disk or viewed in place in the archive.
+class XmlSourceFile
+{
+public:
+	bool Open(const fs::path& filePath);
+	bool Open(const XmlTableFile& file);
+
+	std::string_view GetText() const { return Text; }
+
+private:
+	MappedFile File;
+	std::string_view Text;
+};
+
+uintmax_t getXmlFileSize(const fs::path& filePath);
+
+// Visits every file under a table root in path order, from the archive or the manifest when either covers it. Files on
+// disk are read ahead on the prefetch threads, skipping the ones wanted turns down.
+void forEachTableFile(const fs::path& root, const std::function<void(const XmlTableFile&)>& callback, const std::function<bool(const XmlTableFile&)>& wanted = nullptr);
+
+void forEachXmlFile(const fs::path& root, bool recursiveSearch, const std::function<void(const fs::path&)>& callback);
\ No newline at end of file
@@ -0,0 +1,264 @@
+#include "XmlSpanDocument.h"
+
+#include <cstring>
+
+#include "XmlStreamReader.h"
+
+namespace
+{
+	bool isSpace(char character)
+	{
+		return character == ' ' || character == '\t' || character == '\n' || character == '\r';
+	}
+
+	bool skipPast(char*& position, char* end, std::string_view terminator)
+	{
+		size_t found = std::string_view(position, end - position).find(terminator);
+
+		if (found == std::string_view::npos)
+			return false;
+
+		position += found + terminator.size();
+
+		return true;
+	}
+}
+
+const XmlSpanElement* XmlSpanElement::FirstChildElement(const char* name) const
+{
+	for (int index = FirstChild; index != -1; index = Document->Elements[index].NextSibling)
+		if (name == nullptr || strcmp(Document->Elements[index].ElementName, name) == 0)
+			return &Document->Elements[index];
+
+	return nullptr;
+}
+
+const XmlSpanElement* XmlSpanElement::NextSiblingElement(const char* name) const
+{
+	for (int index = NextSibling; index != -1; index = Document->Elements[index].NextSibling)
+		if (name == nullptr || strcmp(Document->Elements[index].ElementName, name) == 0)
+			return &Document->Elements[index];
+
+	return nullptr;
+}
+
+const char* XmlSpanElement::FindAttribute(const char* name) const
+{
+	for (int i = 0; i < AttributeCount; ++i)
+	{
+		const XmlSpanAttribute& attribute = Document->Attributes[FirstAttribute + i];
+
+		if (strcmp(attribute.Name, name) == 0)
+			return attribute.Value;
+	}
+
+	return nullptr;
+}
+
+const XmlSpanAttribute& XmlSpanElement::GetAttribute(int index) const
+{
+	return Document->Attributes[FirstAttribute + index];
+}
+
+bool XmlSpanDocument::Parse(std::string_view text)
+{
+	Buffer.assign(text.begin(), text.end());
+	Buffer.push_back(0);
+	Elements.clear();
+	Attributes.clear();
+	OpenElements.clear();
+	LastChildren.clear();
+
+	char* position = Buffer.data();
+	char* end = position + text.size();
+
+	while (position < end)
+	{
+		position = (char*)memchr(position, '<', end - position);
+
+		if (position == nullptr)
+			break;
+
+		++position;
+
+		if (*position == '/')
+		{
+			if (OpenElements.size() == 0 || !skipPast(position, end, ">"))
+				return false;
+
+			OpenElements.pop_back();
+		}
+		else if (*position == '?')
+		{
+			if (!skipPast(position, end, "?>"))
+				return false;
+		}
+		else if (*position == '!')
+		{
+			std::string_view markup(position, end - position);
+
+			if (markup.starts_with("!--"))
+			{
+				if (!skipPast(position, end, "-->"))
+					return false;
+			}
+			else if (markup.starts_with("![CDATA["))
+			{
+				if (!skipPast(position, end, "]]>"))
+					return false;
+			}
+			else if (!skipPast(position, end, ">"))
+				return false;
+		}
+		else if (!ParseStartTag(position, end))
+			return false;
+	}
+
+	return Elements.size() > 0 && OpenElements.size() == 0;
+}
+
+bool XmlSpanDocument::ParseStartTag(char*& position, char* end)
+{
+	char* nameEnd = position;
+
+	while (nameEnd < end && !isSpace(*nameEnd) && *nameEnd != '/' && *nameEnd != '>')
+		++nameEnd;
+
+	if (nameEnd == end || nameEnd == position)
+		return false;
+
+	XmlSpanElement element;
+
+	element.Document = this;
+	element.ElementName = position;
+	element.FirstAttribute = (int)Attributes.size();
+
+	char next = *nameEnd;
+
+	*nameEnd = 0;
+	position = nameEnd + 1;
+
+	bool selfClosing = next == '/';
+	bool closed = next == '>';
+
+	if (selfClosing)
+	{
+		if (*position != '>')
+			return false;
+
+		++position;
+		closed = true;
+	}
+
+	while (!closed)
+	{
+		while (position < end && isSpace(*position))
+			++position;
+
+		if (position == end)
+			return false;
+
+		if (*position == '>')
+		{
+			++position;
+
+			break;
+		}
+
+		if (*position == '/')
+		{
+			if (position[1] != '>')
+				return false;
+
+			position += 2;
+			selfClosing = true;
+
+			break;
+		}
+
+		if (!ParseAttribute(position, end))
+			return false;
+	}
+
+	element.AttributeCount = (int)Attributes.size() - element.FirstAttribute;
+
+	int index = (int)Elements.size();
+
+	Elements.push_back(element);
+	LastChildren.push_back(-1);
+
+	if (OpenElements.size() > 0)
+	{
+		int parent = OpenElements.back();
+
+		if (LastChildren[parent] == -1)
+			Elements[parent].FirstChild = index;
+		else
+			Elements[LastChildren[parent]].NextSibling = index;
+
+		LastChildren[parent] = index;
+	}
+	else if (index > 0)
+		return false;
+
+	if (!selfClosing)
+		OpenElements.push_back(index);
+
+	return true;
+}
+
+bool XmlSpanDocument::ParseAttribute(char*& position, char* end)
+{
+	XmlSpanAttribute attribute;
+
+	attribute.Name = position;
+
+	while (position < end && *position != '=' && !isSpace(*position) && *position != '>' && *position != '/')
+		++position;
+
+	if (position == end || position == attribute.Name)
+		return false;
+
+	char next = *position;
+
+	*position = 0;
+	++position;
+
+	if (next != '=')
+	{
+		while (position < end && isSpace(*position))
+			++position;
+
+		if (position == end || *position != '=')
+			return false;
+
+		++position;
+	}
+
+	while (position < end && isSpace(*position))
+		++position;
+
+	if (position == end || (*position != '"' && *position != '\''))
+		return false;
+
+	char quote = *position++;
+	char* value = position;
+	char* valueEnd = (char*)memchr(value, quote, end - value);
+
+	if (valueEnd == nullptr)
+		return false;
+
+	*valueEnd = 0;
+
+	size_t length = valueEnd - value;
+
+	if (memchr(value, '&', length) != nullptr || memchr(value, '\r', length) != nullptr || memchr(value, '\n', length) != nullptr)
+		*decodeXmlAttributeValue(value, length, value) = 0;
+
+	attribute.Value = value;
+	position = valueEnd + 1;
+
+	Attributes.push_back(attribute);
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+class XmlSpanDocument;
+
+struct XmlSpanAttribute
+{
+	const char* Name = nullptr;
+	const char* Value = nullptr;
+};
+
+// Element of an XmlSpanDocument, shaped like the part of tinyxml2::XMLElement the parsers use. Names and values
+// point into the document and stay valid until it parses again.
+struct XmlSpanElement
+{
+	const XmlSpanDocument* Document = nullptr;
+	const char* ElementName = nullptr;
+	int FirstAttribute = 0;
+	int AttributeCount = 0;
+	int FirstChild = -1;
+	int NextSibling = -1;
+
+	const char* Name() const { return ElementName; }
+	const XmlSpanElement* FirstChildElement(const char* name = nullptr) const;
+	const XmlSpanElement* NextSiblingElement(const char* name = nullptr) const;
+	const char* FindAttribute(const char* name) const;
+	const XmlSpanAttribute& GetAttribute(int index) const;
+};
+
+// In situ parser for the subset of XML the game tables use: elements and attributes, with text, comments, declarations
+// and CDATA skipped. One pass over a copy of the text terminates names and values where they are and decodes entities
+// only in the values that contain any, so nothing is allocated per node. The buffers are kept between documents.
+class XmlSpanDocument
+{
+public:
+	bool Parse(std::string_view text);
+
+	const XmlSpanElement* RootElement() const { return Elements.size() > 0 ? &Elements[0] : nullptr; }
+
+private:
+	friend struct XmlSpanElement;
+
+	std::vector<char> Buffer;
+	std::vector<XmlSpanElement> Elements;
+	std::vector<XmlSpanAttribute> Attributes;
+	std::vector<int> OpenElements;
+	std::vector<int> LastChildren;
+
+	bool ParseStartTag(char*& position, char* end);
+	bool ParseAttribute(char*& position, char* end);
+};
\ No newline at end of file
@@ -0,0 +1,372 @@
+#include "XmlStreamReader.h"
+
+#include <cstring>
+
+#include "tinyxml2.h"
+
+namespace
+{
+	bool isSpace(int character)
+	{
+		return character == ' ' || character == '\t' || character == '\n' || character == '\r';
+	}
+}
+
+char* decodeXmlAttributeValue(const char* text, size_t length, char* output)
+{
+	static const std::pair<std::string_view, char> entities[] = {
+		{ "quot", '"' },
+		{ "amp", '&' },
+		{ "apos", '\'' },
+		{ "lt", '<' },
+		{ "gt", '>' }
+	};
+
+	for (size_t i = 0; i < length;)
+	{
+		if (text[i] == '\r' || text[i] == '\n')
+		{
+			char pair = text[i] == '\r' ? '\n' : '\r';
+
+			i += text[i + 1] == pair ? 2 : 1;
+
+			*output++ = '\n';
+
+			continue;
+		}
+
+		if (text[i] != '&')
+		{
+			*output++ = text[i];
+
+			++i;
+
+			continue;
+		}
+
+		if (text[i + 1] == '#')
+		{
+			char value[10] = { 0 };
+			int valueLength = 0;
+
+			const char* adjusted = tinyxml2::XMLUtil::GetCharacterRef(text + i, value, &valueLength);
+
+			if (adjusted != nullptr)
+			{
+				memcpy(output, value, valueLength);
+
+				output += valueLength;
+				i = adjusted - text;
+
+				continue;
+			}
+		}
+		else
+		{
+			bool entityFound = false;
+
+			for (const auto& entity : entities)
+			{
+				if (strncmp(text + i + 1, entity.first.data(), entity.first.size()) == 0 && text[i + 1 + entity.first.size()] == ';')
+				{
+					*output++ = entity.second;
+
+					i += entity.first.size() + 2;
+					entityFound = true;
+
+					break;
+				}
+			}
+
+			if (entityFound)
+				continue;
+		}
+
+		*output++ = '&';
+
+		++i;
+	}
+
+	return output;
+}
+
+const char* XmlStreamElement::FindAttribute(const char* name) const
+{
+	for (const XmlStreamAttribute& attribute : Attributes)
+		if (strcmp(Text.c_str() + attribute.Name, name) == 0)
+			return Text.c_str() + attribute.Value;
+
+	return nullptr;
+}
+
+bool XmlStreamReader::Open(const fs::path& filePath)
+{
+	File.open(filePath, std::ifstream::in | std::ifstream::binary);
+
+	Buffer.resize(1 << 16);
+	Data = Buffer.data();
+	Position = 0;
+	Size = 0;
+	Depth = 0;
+
+	return File.is_open();
+}
+
+void XmlStreamReader::Open(std::string_view text)
+{
+	Data = text.data();
+	Position = 0;
+	Size = text.size();
+	Depth = 0;
+}
+
+int XmlStreamReader::Peek()
+{
+	if (Position == Size)
+	{
+		if (!File.is_open() || !File)
+			return -1;
+
+		File.read(Buffer.data(), Buffer.size());
+
+		Position = 0;
+		Size = (size_t)File.gcount();
+
+		if (Size == 0)
+			return -1;
+	}
+
+	return (unsigned char)Data[Position];
+}
+
+int XmlStreamReader::Next()
+{
+	int character = Peek();
+
+	if (character != -1)
+		++Position;
+
+	return character;
+}
+
+bool XmlStreamReader::SkipPast(std::string_view terminator)
+{
+	size_t matched = 0;
+
+	while (matched < terminator.size())
+	{
+		int character = Next();
+
+		if (character == -1)
+			return false;
+
+		if (character == terminator[matched])
+			++matched;
+		else
+			matched = character == terminator[0] ? 1 : 0;
+	}
+
+	return true;
+}
+
+void XmlStreamReader::SkipSpaces()
+{
+	while (isSpace(Peek()))
+		++Position;
+}
+
+bool XmlStreamReader::NextElement()
+{
+	while (true)
+	{
+		int character = Next();
+
+		while (character != '<' && character != -1)
+			character = Next();
+
+		if (character == -1)
+			return false;
+
+		character = Next();
+
+		if (character == '/' || character == '?' || character == '!')
+		{
+			if (!SkipMarkup(character))
+				return false;
+		}
+		else if (character != -1)
+			return ReadStartTag(character);
+		else
+			return false;
+	}
+}
+
+bool XmlStreamReader::SkipChildren()
+{
+	int depth = Element.Depth;
+
+	while (Depth > depth)
+	{
+		int character = Next();
+
+		while (character != '<' && character != -1)
+			character = Next();
+
+		if (character == -1)
+			return false;
+
+		character = Next();
+
+		if (character == '/' || character == '?' || character == '!')
+		{
+			if (!SkipMarkup(character))
+				return false;
+		}
+		else if (character == -1 || !SkipStartTag())
+			return false;
+	}
+
+	return true;
+}
+
+// end tags, declarations, comments and CDATA, with the character after the '<' already read
+bool XmlStreamReader::SkipMarkup(int character)
+{
+	if (character == '/')
+	{
+		--Depth;
+
+		return SkipPast(">");
+	}
+
+	if (character == '?')
+		return SkipPast("?>");
+
+	if (Peek() == '-')
+		return SkipPast("-->");
+
+	if (Peek() == '[')
+		return SkipPast("]]>");
+
+	return SkipPast(">");
+}
+
+bool XmlStreamReader::SkipStartTag()
+{
+	int previous = 0;
+	int quote = 0;
+
+	for (int character = Next(); character != -1; character = Next())
+	{
+		if (quote != 0)
+		{
+			if (character == quote)
+				quote = 0;
+
+			continue;
+		}
+
+		if (character == '"' || character == '\'')
+			quote = character;
+		else if (character == '>')
+		{
+			if (previous != '/')
+				++Depth;
+
+			return true;
+		}
+
+		previous = character;
+	}
+
+	return false;
+}
+
+bool XmlStreamReader::ReadStartTag(int firstCharacter)
+{
+	Element.Name.clear();
+	Element.Attributes.clear();
+	Element.Depth = Depth;
+	Element.Text.clear();
+
+	int character = firstCharacter;
+
+	while (character != -1 && !isSpace(character) && character != '/' && character != '>')
+	{
+		Element.Name.push_back((char)character);
+
+		character = Next();
+	}
+
+	bool selfClosing = false;
+
+	while (character != '>')
+	{
+		if (isSpace(character))
+		{
+			SkipSpaces();
+
+			character = Next();
+
+			continue;
+		}
+
+		if (character == -1)
+			return false;
+
+		if (character == '/')
+		{
+			selfClosing = true;
+			character = Next();
+
+			continue;
+		}
+
+		XmlStreamAttribute attribute;
+
+		attribute.Name = Element.Text.size();
+
+		while (character != -1 && character != '=' && !isSpace(character))
+		{
+			Element.Text.push_back((char)character);
+
+			character = Next();
+		}
+
+		Element.Text.push_back(0);
+
+		SkipSpaces();
+
+		if (character != '=')
+			character = Next();
+
+		SkipSpaces();
+
+		int quote = Next();
+
+		if (quote != '"' && quote != '\'')
+			return false;
+
+		RawValue.clear();
+
+		for (character = Next(); character != quote && character != -1; character = Next())
+			RawValue.push_back((char)character);
+
+		attribute.Value = Element.Text.size();
+
+		size_t valueStart = Element.Text.size();
+
+		Element.Text.resize(valueStart + RawValue.size());
+		Element.Text.resize(decodeXmlAttributeValue(RawValue.c_str(), RawValue.size(), Element.Text.data() + valueStart) - Element.Text.data());
+
+		Element.Text.push_back(0);
+		Element.Attributes.push_back(attribute);
+
+		character = Next();
+	}
+
+	if (!selfClosing)
+		++Depth;
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// Decodes an attribute value the way tinyxml2 does: newline normalization plus the predefined and numeric entities.
+// text[length] must be readable and terminate the value. Decoding never grows the text, so output may equal text.
+char* decodeXmlAttributeValue(const char* text, size_t length, char* output);
+
+// Offsets into XmlStreamElement::Text, so elements can be copied out of the reader and kept.
+struct XmlStreamAttribute
+{
+	size_t Name = 0;
+	size_t Value = 0;
+};
+
+// Start tag of the element the reader is on. Attribute values are decoded the same way tinyxml2 decodes them.
+struct XmlStreamElement
+{
+	std::string Name;
+	int Depth = 0;
+	std::string Text;
+	std::vector<XmlStreamAttribute> Attributes;
+
+	const char* FindAttribute(const char* name) const;
+};
+
+// Pull parser that reads a file through a fixed size buffer and only keeps the current start tag, for big flat tables
+// that are walked once and never need a DOM. It can also run over text that is already in memory.
+class XmlStreamReader
+{
+public:
+	bool Open(const fs::path& filePath);
+	void Open(std::string_view text);
+
+	// Moves to the next start tag in document order, skipping text, comments, declarations and end tags.
+	bool NextElement();
+
+	// Skips everything under the current element without decoding it, leaving the reader at its end tag.
+	bool SkipChildren();
+
+	const XmlStreamElement& GetElement() const { return Element; }
+
+private:
+	std::ifstream File;
+	std::vector<char> Buffer;
+	const char* Data = nullptr;
+	size_t Position = 0;
+	size_t Size = 0;
+	int Depth = 0;
+	XmlStreamElement Element;
+	std::string RawValue;
+
+	int Peek();
+	int Next();
+	bool SkipPast(std::string_view terminator);
+	void SkipSpaces();
+	bool ReadStartTag(int firstCharacter);
+	bool SkipMarkup(int character);
+	bool SkipStartTag();
+};
\ No newline at end of file
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <algorithm>
+#include <chrono>
 #include <filesystem>
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <unordered_set>
 #include <type_traits>
 
@@ -10,75 +13,446 @@
 #include "XmlData.h"
 #include "XmlParsing.h"
 #include "GraphPrinting.h"
+#include "GraphWriting.h"
+#include "GraphExport.h"
+#include "SkillTraits.h"
+#include "StringTables.h"
+#include "TooltipStore.h"
+#include "IngestStats.h"
+#include "XmlSource.h"
+#include "FilePrefetch.h"
+#include "OutputWriter.h"
+#include "GraphServer.h"
+#include "ReferenceIndex.h"
+#include "FileWatcher.h"
+
+struct QueuedDetailGraph
+{
+	fs::path OutputRoot;
+	ReferenceData Reference;
+};
+
+std::vector<QueuedDetailGraph> queuedDetailGraphs;
+std::unordered_set<std::string> queuedDetailPaths;
 
-void graphClassKit(const fs::path& outputRoot, JobCode jobCode)
+void queueDetailGraphs(const fs::path& outputRoot, const GraphData& graphData)
 {
-	auto jobIndex = jobs.find(jobCode);
+	for (const ReferenceData& reference : graphData.CollapsedNodes)
+	{
+		std::stringstream detailPath;
+
+		detailPath << outputRoot.string() << reference;
+
+		if (queuedDetailPaths.insert(detailPath.str()).second)
+			queuedDetailGraphs.push_back(QueuedDetailGraph{ outputRoot, reference });
+	}
+}
+
+// Other print settings written next to the main graphs, under <output>/<name>/.
+struct OutputVariant
+{
+	std::string Name;
+	GraphPrintSettings Settings;
+};
+
+fs::path graphOutputRoot;
+std::vector<OutputVariant> outputVariants;
+
+// variant 0 is the main output, printed with printSettings
+const GraphPrintSettings& variantSettings(size_t variant)
+{
+	return variant == 0 ? printSettings : outputVariants[variant - 1].Settings;
+}
 
-	if (jobIndex == jobs.end())
+fs::path variantRoot(const fs::path& outputRoot, size_t variant)
+{
+	if (variant == 0)
+		return outputRoot;
+
+	fs::path variantPath = graphOutputRoot;
+	variantPath += outputVariants[variant - 1].Name + "/";
+	variantPath += outputRoot.string().substr(graphOutputRoot.string().size());
+
+	return variantPath;
+}
+
+// Prints the graph for the main settings and every variant. Variants that agree on the structural print flags share one
+// traversal and only have their labels written separately.
+void printGraph(const fs::path& outputRoot, const fs::path& detailRoot, GraphPackKey key)
+{
+	GraphRoot root;
+
+	if (!findGraphRoot(key, root))
 		return;
 
-	JobData& job = jobIndex->second;
+	size_t variantCount = outputVariants.size() + 1;
+
+	std::vector<std::stringstream> outFiles(variantCount);
+	std::vector<bool> printed(variantCount, false);
+
+	for (size_t i = 0; i < variantCount; ++i)
+	{
+		if (printed[i])
+			continue;
+
+		GraphData graphData{ outFiles[i], root.RootName, root.RootLabel };
 
-	fs::create_directories(outputRoot);
+		graphData.Settings = variantSettings(i);
 
-	std::string jobName = job.Name;
+		for (size_t j = i + 1; j < variantCount; ++j)
+		{
+			const GraphPrintSettings& settings = variantSettings(j);
 
-	for (int i = 0; i < jobName.size(); ++i)
-		if (jobName[i] == ' ')
-			jobName[i] = '_';
+			if (printed[j] || (settings.Flags & structuralPrintFlags) != (graphData.Settings.Flags & structuralPrintFlags))
+				continue;
 
-	fs::path outputPath = outputRoot;
-	outputPath += jobName;
-	outputPath += ".digraph";
+			graphData.AddVariant(outFiles[j], settings);
 
-	std::ofstream outFile(outputPath, std::ofstream::out);
+			printed[j] = true;
+		}
 
-	GraphData graphData { outFile, jobName, job.Name };
+		graphData.Output() << root.Header;
 
-	outFile << "digraph " << jobName << "_Kit {\n";
+		root.Print(graphData);
 
-	graphData.PrintRoot(job);
+		graphData.Output() << "}\n";
 
-	graphData.PrintLinked();
+		queueDetailGraphs(detailRoot, graphData);
+	}
 
-	outFile << "}" << std::endl;
+	for (size_t i = 0; i < variantCount; ++i)
+	{
+		key.Variant = (uint32_t)i;
 
-	outFile.close();
+		writeGraph(variantRoot(outputRoot, i), root.FileName, root.RootName, key, outFiles[i].str());
+	}
 }
 
-void graphSetBonus(const fs::path& outputRoot, int setId, const SetBonusData& setData)
+// Parses everything the graphs are built from into model().
+bool loadModel(const fs::path& xmlRootPath, const fs::path& manifestPath, bool keepEveryItem)
 {
-	fs::create_directories(outputRoot);
+	fs::path tableRootPath = xmlRootPath;
+	tableRootPath += "table/";
 
-	std::string setName = Desanitize(setData.Name);
-	std::string setVarName = setName;
+	if (!loadFeatures(tableRootPath, "NA", "Live"))
+		return false;
 
-	for (int i = 0; i < setVarName.size(); ++i)
-		if (setVarName[i] == ' ' || setVarName[i] == '(' || setVarName[i] == ')' || setVarName[i] == '\'')
-			setVarName[i] = '_';
+	fs::path effectRootPath = xmlRootPath;
+	effectRootPath += "additionaleffect/";
 
-	char idString[16] = { 0 };
+	fs::path skillRootPath = xmlRootPath;
+	skillRootPath += "skill/";
 
-	_itoa_s(setId, idString, 16, 10);
+	fs::path stringRootPath = xmlRootPath;
+	stringRootPath += "string/en/";
 
-	fs::path outputPath = outputRoot;
-	outputPath += idString;
-	outputPath += "_" + setVarName;
-	outputPath += ".digraph";
+	fs::path magicPath = xmlRootPath;
+	magicPath += "table/magicpath.xml";
 
-	std::ofstream outFile(outputPath, std::ofstream::out);
+	fs::path jobPath = xmlRootPath;
+	jobPath += "table/job.xml";
+
+	fs::path setItemInfoPath = xmlRootPath;
+	setItemInfoPath += "table/setiteminfo.xml";
 
-	GraphData graphData{ outFile, setVarName, setName };
+	fs::path setItemOptionPath = xmlRootPath;
+	setItemOptionPath += "table/setitemoption.xml";
+
+	fs::path itemRootPath = xmlRootPath;
+	itemRootPath += "item/";
 
-	outFile << "digraph " << setVarName << "_Kit {\n";
+	// one walk of the per id file trees, reused by later runs while none of their directories change
+	if (!xmlArchive.IsOpen())
+	{
+		std::vector<fs::path> manifestRoots = { effectRootPath, skillRootPath, itemRootPath };
 
-	graphData.PrintRoot(setData);
-	graphData.PrintLinked();
+		if (manifestPath.empty() || !fileManifest.Load(manifestPath, manifestRoots))
+		{
+			fileManifest.Build(manifestRoots);
 
-	outFile << "}" << std::endl;
+			if (!manifestPath.empty())
+				fileManifest.Save(manifestPath);
+		}
+	}
 
-	outFile.close();
+	ParseMagicPaths(magicPath);
+	forEachTableFile(effectRootPath, &ParseAdditionalEffect);
+	forEachTableFile(skillRootPath, &ParseSkill);
+	ParseJobs(jobPath);
+	ParseSetBonusOptions(setItemOptionPath);
+	ParseSetBonuses(setItemInfoPath);
+
+	// the whole dataset export wants every item, the graphs only need set pieces and the filtered ranges
+	if (keepEveryItem)
+		itemFilter.Enabled = false;
+
+	for (const std::pair<const int, SetBonusData>& setBonus : model().SetBonuses)
+		itemFilter.KeepIds.insert(setBonus.second.ItemIds.begin(), setBonus.second.ItemIds.end());
+
+	forEachTableFile(itemRootPath, &ParseItems, [](const XmlTableFile& file) { return itemFilter.Keeps(file.Id); });
+	loadStringTables(stringRootPath);
+	poolLabels();
+	computeSkillTraits();
+
+	return true;
+}
+
+const JobCode graphedJobs[] = {
+	JobCode::Beginner,
+	JobCode::Knight,
+	JobCode::Berserker,
+	JobCode::Wizard,
+	JobCode::Priest,
+	JobCode::Archer,
+	JobCode::HeavyGunner,
+	JobCode::Thief,
+	JobCode::Assassin,
+	JobCode::Runeblade,
+	JobCode::Striker,
+	JobCode::SoulBinder,
+	JobCode::GameMaster
+};
+
+// the class kits and then every set bonus, in the order a full run prints them
+std::vector<GraphPackKey> getRootGraphs()
+{
+	std::vector<GraphPackKey> roots;
+
+	for (JobCode job : graphedJobs)
+		roots.push_back(GraphPackKey{ GraphPackKind::ClassKit, (int)job });
+
+	for (const std::pair<const int, SetBonusData>& setBonus : model().SetBonuses)
+		roots.push_back(GraphPackKey{ GraphPackKind::SetBonus, setBonus.first });
+
+	return roots;
+}
+
+// Prints each root graph and then the detail graphs they collapsed, and waits for all of them to be written.
+void printRootGraphs(const std::vector<GraphPackKey>& roots)
+{
+	queuedDetailGraphs.clear();
+	queuedDetailPaths.clear();
+
+	for (const GraphPackKey& key : roots)
+	{
+		fs::path rootPath = graphOutputRoot;
+		rootPath += key.Kind == GraphPackKind::ClassKit ? "classKits/" : "setBonuses/";
+
+		printGraph(rootPath, rootPath / "details/", key);
+	}
+
+	for (size_t i = 0; i < queuedDetailGraphs.size(); ++i)
+	{
+		QueuedDetailGraph detail = queuedDetailGraphs[i];
+
+		GraphPackKey key{ detail.Reference.Type == ReferenceType::Skill ? GraphPackKind::SkillDetail : GraphPackKind::EffectDetail, detail.Reference.Id, detail.Reference.Level };
+
+		printGraph(detail.OutputRoot, detail.OutputRoot, key);
+	}
+
+	waitForGraphWrites();
+}
+
+enum class WatchedFiles
+{
+	Skills,
+	Effects,
+	Items,
+	Tables
+};
+
+struct WatchedDirectory
+{
+	fs::path Path;
+	WatchedFiles Files;
+};
+
+struct ChangedFile
+{
+	WatchedFiles Files;
+	XmlTableFile File;
+};
+
+// Works out which graphs a batch of changed files touches and brings the model up to date for them. Skill, effect and
+// item files are parsed again on their own, and the reverse references of what they define lead to the class kits and
+// set bonuses that reach them. Anything under table/ or string/ can change every graph, so that loads the whole model
+// again. False if the model couldn't be loaded.
+bool updateModel(const std::vector<WatchedDirectory>& directories, const std::vector<fs::path>& changed, const fs::path& xmlRootPath, const fs::path& manifestPath, ReferenceIndex& referrers, bool& reloadAll, std::vector<GraphPackKey>& graphs)
+{
+	std::vector<ChangedFile> files;
+
+	for (const fs::path& path : changed)
+	{
+		std::string pathText = path.string();
+
+		for (const WatchedDirectory& directory : directories)
+		{
+			std::string directoryText = directory.Path.string();
+
+			if (pathText.compare(0, directoryText.size(), directoryText) != 0)
+				continue;
+
+			// the watched directory itself is reported when events were lost
+			if (directory.Files == WatchedFiles::Tables || pathText.size() <= directoryText.size())
+				reloadAll = true;
+			else if (path.extension() == ".xml")
+				files.push_back(ChangedFile{ directory.Files, XmlTableFile{ path, readFileId(path.filename().string()), getXmlFileSize(path) } });
+
+			break;
+		}
+	}
+
+	if (reloadAll)
+	{
+		*sharedModel = GraphModel();
+		ingestStats.PrefetchStages.clear();
+
+		if (!loadModel(xmlRootPath, manifestPath, false))
+			return false;
+
+		reloadAll = false;
+
+		referrers.Build();
+		graphs = getRootGraphs();
+
+		return true;
+	}
+
+	std::vector<GraphNodeId> nodes;
+	bool reloadStrings = false;
+
+	for (const ChangedFile& file : files)
+	{
+		if (file.Files == WatchedFiles::Skills)
+		{
+			reloadStrings |= !ReparseSkill(file.File);
+			nodes.push_back(GraphNodeId{ GraphNodeType::Skill, file.File.Id });
+		}
+		else if (file.Files == WatchedFiles::Effects)
+		{
+			reloadStrings |= !ReparseAdditionalEffect(file.File);
+			nodes.push_back(GraphNodeId{ GraphNodeType::Effect, file.File.Id });
+		}
+		else if (itemFilter.Keeps(file.File.Id))
+		{
+			reloadStrings |= !ReparseItem(file.File);
+			nodes.push_back(GraphNodeId{ GraphNodeType::Item, file.File.Id });
+		}
+	}
+
+	if (nodes.size() == 0)
+		return true;
+
+	if (reloadStrings)
+	{
+		fs::path stringRootPath = xmlRootPath;
+		stringRootPath += "string/en/";
+
+		loadStringTables(stringRootPath);
+	}
+
+	// a changed splash or sensor trigger also changes how the skill it points at prints, wherever that is
+	std::unordered_map<int, SkillTraits> previousTraits;
+
+	for (const std::pair<const int, SkillData>& skill : model().Skills)
+		previousTraits[skill.first] = skill.second.Traits;
+
+	poolLabels();
+	computeSkillTraits();
+	referrers.Update(nodes);
+
+	std::vector<GraphNodeId> changedNodes = nodes;
+
+	for (const std::pair<const int, SkillData>& skill : model().Skills)
+	{
+		auto previous = previousTraits.find(skill.first);
+
+		if (previous == previousTraits.end() || !(previous->second == skill.second.Traits))
+			changedNodes.push_back(GraphNodeId{ GraphNodeType::Skill, skill.first });
+	}
+
+	std::vector<GraphNodeId> roots;
+	std::unordered_set<uint64_t> rootKeys;
+
+	referrers.FindRoots(changedNodes, roots);
+
+	for (const GraphNodeId& root : roots)
+		rootKeys.insert(getNodeKey(root));
+
+	for (const GraphPackKey& key : getRootGraphs())
+		if (rootKeys.contains(getNodeKey(GraphNodeId{ key.Kind == GraphPackKind::ClassKit ? GraphNodeType::Job : GraphNodeType::SetBonus, key.Id })))
+			graphs.push_back(key);
+
+	return true;
+}
+
+// Keeps the output up to date with the xml tree after a full run, printing only the graphs each change reaches.
+int watchGraphs(const fs::path& xmlRootPath, const fs::path& manifestPath, int quietMilliseconds)
+{
+	std::vector<WatchedDirectory> directories = {
+		{ "skill/", WatchedFiles::Skills },
+		{ "additionaleffect/", WatchedFiles::Effects },
+		{ "item/", WatchedFiles::Items },
+		{ "table/", WatchedFiles::Tables },
+		{ "string/", WatchedFiles::Tables }
+	};
+
+	std::vector<fs::path> watchedPaths;
+
+	for (WatchedDirectory& directory : directories)
+	{
+		fs::path path = xmlRootPath;
+		path += directory.Path;
+
+		directory.Path = path;
+
+		if (fs::is_directory(path))
+			watchedPaths.push_back(path);
+	}
+
+	FileWatcher watcher;
+
+	if (!watcher.Watch(watchedPaths))
+	{
+		std::cout << "couldn't watch: " << xmlRootPath.string() << std::endl;
+
+		return -1;
+	}
+
+	ReferenceIndex referrers;
+
+	referrers.Build();
+
+	std::cout << "watching " << xmlRootPath.string() << " for changes" << std::endl;
+
+	std::vector<fs::path> changed;
+	bool reloadAll = false;
+
+	while (watcher.WaitForChanges(quietMilliseconds, changed))
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		std::vector<GraphPackKey> graphs;
+
+		// a model that failed to load stays unusable until a later change loads it whole
+		if (!updateModel(directories, changed, xmlRootPath, manifestPath, referrers, reloadAll, graphs))
+		{
+			std::cout << "couldn't load the model, waiting for another change" << std::endl;
+
+			reloadAll = true;
+
+			continue;
+		}
+
+		printRootGraphs(graphs);
+
+		long long milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+		std::cout << changed.size() << " changed files, regenerated " << graphs.size() << " graphs and " << queuedDetailGraphs.size() << " details in " << milliseconds << " ms" << std::endl;
+	}
+
+	std::cout << "stopped watching " << xmlRootPath.string() << std::endl;
+
+	return -1;
 }
 
 //template <class ParentClass>
@@ -157,86 +531,361 @@ int main(int argc, char** argv)
 	fs::path xmlRootPath = "B:/Documents/MapleServer2/GameDataParser/Resources/Xml/";
 	fs::path outputRootPath = "B:/Documents/Ms2DependencyGraph/output/";
 
-	fs::path tableRootPath = xmlRootPath;
-	tableRootPath += "table/";
+	fs::path archivePath;
+	fs::path packPath;
+	fs::path manifestPath;
+	fs::path outputPackPath;
+	fs::path readPackPath;
+	const char* packedGraphText = nullptr;
+	GraphPackKey packedGraph;
+	bool showPackedGraph = false;
+	fs::path readTooltipsPath;
+	TooltipStoreEntry tooltipKey;
+	bool showTooltip = false;
+
+	std::string serveAddress;
+
+	bool watch = false;
+	int watchQuietMilliseconds = 100;
+
+	bool exportEverything = false;
+	GraphExportFormat exportFormat = GraphExportFormat::Dot;
+
+	const auto readOption = [] <size_t Length> (const char* argument, const char(&name)[Length]) -> const char*
+	{
+		return strncmp(argument, name, Length - 1) == 0 ? argument + Length - 1 : nullptr;
+	};
 
-	if (!loadFeatures(tableRootPath, "NA", "Live"))
+	for (int i = 1; i < argc; ++i)
+	{
+		const char* value = nullptr;
+
+		if ((value = readOption(argv[i], "--xml=")) != nullptr)
+			xmlRootPath = value;
+		else if ((value = readOption(argv[i], "--archive=")) != nullptr)
+			archivePath = value;
+		else if ((value = readOption(argv[i], "--pack=")) != nullptr)
+			packPath = value;
+		else if ((value = readOption(argv[i], "--manifest=")) != nullptr)
+			manifestPath = value;
+		else if ((value = readOption(argv[i], "--output-pack=")) != nullptr)
+			outputPackPath = value;
+		else if ((value = readOption(argv[i], "--from-pack=")) != nullptr)
+			readPackPath = value;
+		else if ((value = readOption(argv[i], "--graph=")) != nullptr)
+			packedGraphText = value;
+		else if ((value = readOption(argv[i], "--from-tooltips=")) != nullptr)
+			readTooltipsPath = value;
+		else if ((value = readOption(argv[i], "--tooltip=")) != nullptr)
+		{
+			showTooltip = readTooltipKey(value, tooltipKey);
+
+			if (!showTooltip)
+			{
+				std::cout << "unknown tooltip: " << value << std::endl;
+
+				return -1;
+			}
+		}
+		else if ((value = readOption(argv[i], "--serve=")) != nullptr)
+			serveAddress = value;
+		else if (strcmp(argv[i], "--watch") == 0)
+			watch = true;
+		else if ((value = readOption(argv[i], "--watch=")) != nullptr)
+		{
+			watch = true;
+			watchQuietMilliseconds = std::max(0, atoi(value));
+		}
+		else if ((value = readOption(argv[i], "--output=")) != nullptr)
+			outputRootPath = value;
+		else if ((value = readOption(argv[i], "--split=")) != nullptr)
+		{
+			if (strcmp(value, "files") == 0)
+				outputSettings.SplitMode = GraphSplitMode::Files;
+			else if (strcmp(value, "clusters") == 0)
+				outputSettings.SplitMode = GraphSplitMode::Clusters;
+			else if (strcmp(value, "none") == 0)
+				outputSettings.SplitMode = GraphSplitMode::None;
+			else
+			{
+				std::cout << "unknown split mode: " << value << std::endl;
+
+				return -1;
+			}
+		}
+		else if ((value = readOption(argv[i], "--max-part-nodes=")) != nullptr)
+			outputSettings.MaxPartNodes = atoi(value);
+		else if ((value = readOption(argv[i], "--format=")) != nullptr)
+		{
+			if (strcmp(value, "digraph") == 0)
+				outputSettings.Format = GraphOutputFormat::Digraph;
+			else if (strcmp(value, "svg") == 0)
+				outputSettings.Format = GraphOutputFormat::Svg;
+			else
+			{
+				std::cout << "unknown output format: " << value << std::endl;
+
+				return -1;
+			}
+		}
+		else if ((value = readOption(argv[i], "--layout-sweeps=")) != nullptr)
+			outputSettings.Layout.CrossingSweeps = atoi(value);
+		else if ((value = readOption(argv[i], "--print=")) != nullptr)
+		{
+			// a misspelled setting would otherwise print every graph with the wrong flags
+			if (!readPrintSettings(value, printSettings))
+				return -1;
+		}
+		else if ((value = readOption(argv[i], "--variant=")) != nullptr)
+		{
+			const char* separator = strchr(value, ':');
+
+			OutputVariant variant{ separator != nullptr ? std::string(value, separator) : value };
+
+			if (separator != nullptr && !readPrintSettings(separator + 1, variant.Settings))
+				return -1;
+
+			outputVariants.push_back(variant);
+		}
+		else if ((value = readOption(argv[i], "--print-config=")) != nullptr)
+		{
+			if (!loadPrintSettings(value, printSettings))
+			{
+				std::cout << "couldn't read print settings: " << value << std::endl;
+
+				return -1;
+			}
+		}
+		else if ((value = readOption(argv[i], "--max-depth=")) != nullptr)
+			traversalLimits.MaxDepth = atoi(value);
+		else if ((value = readOption(argv[i], "--max-nodes=")) != nullptr)
+			traversalLimits.MaxNodes = atoi(value);
+		else if ((value = readOption(argv[i], "--max-fan-out=")) != nullptr)
+			traversalLimits.MaxFanOut = atoi(value);
+		else if ((value = readOption(argv[i], "--tooltips=")) != nullptr)
+			outputSettings.SidecarTooltips = strcmp(value, "sidecar") == 0;
+		else if ((value = readOption(argv[i], "--item-filter=")) != nullptr)
+			itemFilter.Enabled = strcmp(value, "off") != 0;
+		else if ((value = readOption(argv[i], "--item-prefixes=")) != nullptr)
+		{
+			std::vector<int> prefixes;
+
+			readValues(value, prefixes);
+
+			itemFilter.KeepPrefixes.insert(prefixes.begin(), prefixes.end());
+		}
+		else if ((value = readOption(argv[i], "--compress=")) != nullptr)
+		{
+			const char* level = strchr(value, ':');
+
+			if (strncmp(value, "gzip", 4) != 0 && strncmp(value, "off", 3) != 0)
+				std::cout << "only gzip compression is built in, using gzip for: " << value << std::endl;
+
+			outputSettings.CompressionLevel = strncmp(value, "off", 3) == 0 ? 0 : level != nullptr ? std::clamp(atoi(level + 1), 1, 9) : 6;
+		}
+		else if ((value = readOption(argv[i], "--write-queue=")) != nullptr)
+			outputSettings.WriteQueueLength = atoi(value);
+		else if ((value = readOption(argv[i], "--io-threads=")) != nullptr)
+			prefetchSettings.IoThreads = atoi(value);
+		else if ((value = readOption(argv[i], "--io-buffers=")) != nullptr)
+			prefetchSettings.BufferCount = std::max(1, atoi(value));
+		else if ((value = readOption(argv[i], "--parser=")) != nullptr)
+		{
+			if (strcmp(value, "tinyxml2") == 0)
+				xmlParserMode = XmlParserMode::Tinyxml2;
+			else if (strcmp(value, "verify") == 0)
+				xmlParserMode = XmlParserMode::Verify;
+			else if (strcmp(value, "insitu") == 0)
+				xmlParserMode = XmlParserMode::InSitu;
+			else
+			{
+				// a misspelled verify would otherwise skip the parser check and pass
+				std::cout << "unknown parser: " << value << std::endl;
+
+				return -1;
+			}
+		}
+		else if ((value = readOption(argv[i], "--export=")) != nullptr)
+		{
+			exportEverything = true;
+
+			if (strcmp(value, "dot") == 0)
+				exportFormat = GraphExportFormat::Dot;
+			else if (strcmp(value, "edges") == 0)
+				exportFormat = GraphExportFormat::EdgeList;
+			else
+			{
+				std::cout << "unknown export format: " << value << std::endl;
+
+				return -1;
+			}
+		}
+		else
+			std::cout << "unknown option: " << argv[i] << std::endl;
+	}
+
+	// read once every --variant is known, since the graph can name one
+	if (packedGraphText != nullptr)
+	{
+		std::vector<std::string> variantNames;
+
+		for (const OutputVariant& variant : outputVariants)
+			variantNames.push_back(variant.Name);
+
+		showPackedGraph = readGraphPackKey(packedGraphText, packedGraph, variantNames);
+
+		// without a graph to show, --from-pack would unpack everything instead
+		if (!showPackedGraph)
+		{
+			std::cout << "unknown graph: " << packedGraphText << std::endl;
+
+			return -1;
+		}
+	}
+
+	// watching needs the xml tree on disk and graphs written as their own files
+	if (watch && (!archivePath.empty() || !outputPackPath.empty()))
+	{
+		std::cout << "--watch doesn't work with --archive or --output-pack, writing the graphs once" << std::endl;
+
+		watch = false;
+	}
+
+	// repacks the extracted tree into one file for --archive to read on later runs
+	if (!packPath.empty())
+		return writeXmlArchive(xmlRootPath, packPath) ? 0 : -1;
+
+	// serves one graph from an earlier run's pack, or unpacks the whole thing into the output tree
+	if (!readPackPath.empty())
+	{
+		GraphPack pack;
+
+		if (!pack.Open(readPackPath))
+		{
+			std::cout << "couldn't open graph pack: " << readPackPath.string() << std::endl;
+
+			return -1;
+		}
+
+		if (!showPackedGraph)
+			return pack.Extract(outputRootPath) ? 0 : -1;
+
+		const GraphPackEntry* entry = pack.Find(packedGraph);
+		std::string text;
+
+		if (entry == nullptr || !pack.Read(*entry, text))
+		{
+			std::cout << "graph isn't in the pack" << std::endl;
+
+			return -1;
+		}
+
+		std::cout << text;
+
+		return 0;
+	}
+
+	// looks a description up in an earlier run's tooltip sidecar
+	if (!readTooltipsPath.empty())
+	{
+		TooltipStore store;
+
+		if (!store.Open(readTooltipsPath))
+		{
+			std::cout << "couldn't open tooltips: " << readTooltipsPath.string() << std::endl;
+
+			return -1;
+		}
+
+		std::string_view text = showTooltip ? store.Find(tooltipKey.Type, tooltipKey.Id, tooltipKey.Level) : std::string_view();
+
+		if (text.size() == 0)
+		{
+			std::cout << "tooltip isn't in the store" << std::endl;
+
+			return -1;
+		}
+
+		std::cout << text << std::endl;
+
+		return 0;
+	}
+
+	// archive paths are relative to the packed tree's root
+	if (!archivePath.empty())
+	{
+		if (!xmlArchive.Open(archivePath))
+		{
+			std::cout << "couldn't open archive: " << archivePath.string() << std::endl;
+
+			return -1;
+		}
+
+		xmlRootPath.clear();
+	}
+
+	if (!serveAddress.empty())
+		return serveGraphs(serveAddress, [xmlRootPath, manifestPath]() { return loadModel(xmlRootPath, manifestPath, false); });
+
+	if (!loadModel(xmlRootPath, manifestPath, exportEverything))
 		return -1;
 
-	fs::path effectRootPath = xmlRootPath;
-	effectRootPath += "additionaleffect/";
+	printIngestStats(std::cout);
 
-	fs::path skillRootPath = xmlRootPath;
-	skillRootPath += "skill/";
+	// the parser check fails the run when the parsers disagree, so it can be used as a test
+	if (ingestStats.MismatchedFiles > 0)
+		return -1;
 
-	fs::path stringRootPath = xmlRootPath;
-	stringRootPath += "string/en/";
+	if (exportEverything)
+	{
+		fs::path exportPath = outputRootPath;
+		exportPath += exportFormat == GraphExportFormat::Dot ? "everything.digraph" : "everything.edges";
 
-	fs::path magicPath = xmlRootPath;
-	magicPath += "table/magicpath.xml";
+		if (outputSettings.CompressionLevel > 0)
+			exportPath += ".gz";
 
-	fs::path jobPath = xmlRootPath;
-	jobPath += "table/job.xml";
+		exportGraph(exportPath, exportFormat, outputSettings.CompressionLevel);
 
-	fs::path jobNamePath = xmlRootPath;
-	jobNamePath += "string/en/jobname.xml";
+		return 0;
+	}
 
-	fs::path classKitPath = outputRootPath;
-	classKitPath += "classKits/";
+	if (outputSettings.SidecarTooltips)
+	{
+		fs::path tooltipPath = outputRootPath;
+		tooltipPath += "tooltips.bin";
 
-	fs::path setItemInfoPath = xmlRootPath;
-	setItemInfoPath += "table/setiteminfo.xml";
+		if (!writeTooltipStore(tooltipPath))
+		{
+			std::cout << "couldn't write tooltips: " << tooltipPath.string() << std::endl;
 
-	fs::path setItemOptionPath = xmlRootPath;
-	setItemOptionPath += "table/setitemoption.xml";
+			return -1;
+		}
+	}
+
+	if (!outputPackPath.empty() && !getOutputWriter().OpenPack(outputPackPath, outputRootPath))
+	{
+		std::cout << "couldn't create graph pack: " << outputPackPath.string() << std::endl;
 
-	fs::path setItemNamePath = xmlRootPath;
-	setItemNamePath += "string/en/setitemname.xml";
+		return -1;
+	}
 
-	fs::path setBonusPath = outputRootPath;
-	setBonusPath += "setBonuses/";
+	graphOutputRoot = outputRootPath;
 
-	fs::path itemRootPath = xmlRootPath;
-	itemRootPath += "item/";
+	printRootGraphs(getRootGraphs());
 
-	fs::path itemStringPath = xmlRootPath;
-	itemStringPath += "string/en/itemname.xml";
+	// the index is written on close, and a pack without one can't be opened
+	if (!outputPackPath.empty() && !getOutputWriter().ClosePack())
+	{
+		std::cout << "couldn't finish graph pack: " << outputPackPath.string() << std::endl;
 
-	fs::path itemDescPath = xmlRootPath;
-	itemDescPath += "string/en/koritemdescription.xml";
+		return -1;
+	}
 
-	ParseMagicPaths(magicPath);
-	forEachFile(effectRootPath, true, &ParseAdditionalEffect);
-	forEachFile(skillRootPath, true, &ParseSkill);
-	forEachFile(stringRootPath, true, &ParseStrings);
-	ParseJobs(jobPath);
-	forEachFile(itemRootPath, true, &ParseItems);
-	ParseJobStrings(jobNamePath);
-	ParseItemStrings(itemStringPath);
-	ParseItemDescriptionStrings(itemDescPath);
-	ParseSetBonusOptions(setItemOptionPath);
-	ParseSetBonuses(setItemInfoPath);
-	ParseSetBonusStrings(setItemNamePath);
-
-	JobCode jobs[] = {
-		JobCode::Beginner,
-		JobCode::Knight,
-		JobCode::Berserker,
-		JobCode::Wizard,
-		JobCode::Priest,
-		JobCode::Archer,
-		JobCode::HeavyGunner,
-		JobCode::Thief,
-		JobCode::Assassin,
-		JobCode::Runeblade,
-		JobCode::Striker,
-		JobCode::SoulBinder,
-		JobCode::GameMaster
-	};
+	printGraphWriteStats(std::cout);
 
-	for (int i = 0; i < sizeof(jobs) / sizeof(JobCode); ++i)
-		graphClassKit(classKitPath, jobs[i]);
+	if (getOutputWriter().GetFilesFailed() > 0)
+		return -1;
 
-	for (const std::pair<int, SetBonusData>& setBonus : setBonuses)
-		graphSetBonus(setBonusPath, setBonus.first, setBonus.second);
+	if (watch)
+		return watchGraphs(xmlRootPath, manifestPath, watchQuietMilliseconds);
 }
\ No newline at end of file
@@ -0,0 +1,122 @@
+"""Runs Ms2DependencyGraph over the fixture tree next to this script and fails if two ways of reading the same data
+print different graphs.
+
+usage: check_fixture.py <path to the Ms2DependencyGraph executable>
+"""
+
+import os
+import subprocess
+import sys
+import tempfile
+
+fixtureRoot = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'Fixture') + '/'
+
+
+def run(executable, *arguments, expectedOutput=None):
+	result = subprocess.run([executable, *arguments], stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True)
+	passed = result.returncode == 0 and (expectedOutput is None or expectedOutput in result.stdout)
+
+	if not passed:
+		print(result.stdout)
+
+	return passed
+
+
+def readTree(root):
+	files = {}
+
+	for directory, _, names in os.walk(root):
+		for name in names:
+			path = os.path.join(directory, name)
+
+			with open(path, 'rb') as file:
+				files[os.path.relpath(path, root)] = file.read()
+
+	return files
+
+
+def compareTrees(name, expectedRoot, actualRoot):
+	expected = readTree(expectedRoot)
+	actual = readTree(actualRoot)
+	differences = sorted(path for path in expected.keys() | actual.keys() if expected.get(path) != actual.get(path))
+
+	for path in differences:
+		print('%s: %s differs' % (name, path))
+
+	if len(expected) == 0:
+		print('%s: nothing was written' % name)
+
+	return len(differences) == 0 and len(expected) > 0
+
+
+# a packed archive has to give the same graphs as the tree it was packed from
+def checkArchive(executable, workRoot):
+	archivePath = os.path.join(workRoot, 'fixture.pack')
+	treeOutput = os.path.join(workRoot, 'tree') + '/'
+	archiveOutput = os.path.join(workRoot, 'archive') + '/'
+
+	return (run(executable, '--xml=' + fixtureRoot, '--pack=' + archivePath)
+		and run(executable, '--xml=' + fixtureRoot, '--output=' + treeOutput)
+		and run(executable, '--archive=' + archivePath, '--output=' + archiveOutput)
+		and compareTrees('archive', treeOutput, archiveOutput))
+
+
+# the tinyxml2 and in situ parsers have to build the same model from the skill and effect files, which in the fixture
+# have CRLF line ends, comments, CDATA, single quoted values and numbers written as decimal and hex character references
+def checkParsers(executable, workRoot):
+	tinyxml2Output = os.path.join(workRoot, 'tinyxml2') + '/'
+	inSituOutput = os.path.join(workRoot, 'insitu') + '/'
+	verifyOutput = os.path.join(workRoot, 'verify') + '/'
+
+	# --parser=verify exits with an error when any file parses differently
+	return (run(executable, '--xml=' + fixtureRoot, '--output=' + verifyOutput, '--parser=verify', expectedOutput=' mismatched')
+		and run(executable, '--xml=' + fixtureRoot, '--output=' + tinyxml2Output, '--parser=tinyxml2')
+		and run(executable, '--xml=' + fixtureRoot, '--output=' + inSituOutput, '--parser=insitu')
+		and compareTrees('parsers', tinyxml2Output, inSituOutput))
+
+
+# the tooltip sidecar has to open again and give back the descriptions from the string tables. Output is read as text,
+# so the CRLF in the skill description comes back as a plain line break
+def checkTooltips(executable, workRoot):
+	tooltipsPath = os.path.join(workRoot, 'tooltips.bin')
+	lookups = [
+		('skill:10000001', 'Deals damage\ncrlf\nlf \\ back\n'),
+		('effect:50000001', 'Tip\ntwo\n'),
+		('item:11300001', 'Tip\nA')
+	]
+
+	return (run(executable, '--xml=' + fixtureRoot, '--output=' + workRoot + '/', '--tooltips=sidecar')
+		and all(run(executable, '--from-tooltips=' + tooltipsPath, '--tooltip=' + key, expectedOutput=text) for key, text in lookups))
+
+
+checks = [
+	('archive', checkArchive),
+	('parsers', checkParsers),
+	('tooltips', checkTooltips)
+]
+
+
+def main():
+	if len(sys.argv) != 2:
+		print(__doc__)
+
+		return 2
+
+	failed = 0
+
+	with tempfile.TemporaryDirectory() as workRoot:
+		for name, check in checks:
+			checkRoot = os.path.join(workRoot, name)
+
+			os.makedirs(checkRoot)
+
+			passed = check(sys.argv[1], checkRoot)
+			failed += 0 if passed else 1
+
+			print('%s: %s' % (name, 'ok' if passed else 'FAILED'))
+
+	return 1 if failed > 0 else 0
+
+
+if __name__ == '__main__':
+	sys.exit(main())
\ No newline at end of file